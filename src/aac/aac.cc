@@ -1,14 +1,20 @@
+#include <pthread.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <atomic>
+
 #include <neaacdec.h>
 
 #include <audacious/audtag.h>
+#include <libaudcore/audstrings.h>
 #include <libaudcore/i18n.h>
 #include <libaudcore/plugin.h>
 #include <libaudcore/runtime.h>
 
+#include "../plugin-common/disk-cache.h"
+
 class AACDecoder : public InputPlugin
 {
 public:
@@ -255,15 +261,243 @@ static void calc_aac_info (VFSFile & handle, int * length, int * bitrate,
         NeAACDecClose (decoder);
 }
 
+/*
+ * ADTS frame index.  Walking the frame headers (without decoding anything)
+ * gives the exact number of samples and the byte offset of every frame.
+ * This is done in the background during playback; the result is cached per
+ * file and used for the length and for seeking from then on.
+ */
+
+#define INDEX_STEP 16  /* ADTS frames per index entry */
+#define INDEX_CHUNK 65536
+
+/* at most 16 MB of frame indexes */
+static DiskCache index_cache ("aac-index", "ADTX", 2, 16 << 20);
+
+struct AdtsIndexEntry
+{
+    int64_t offset;
+    int64_t block;  /* raw data blocks (1024 samples each) before this frame */
+};
+
+struct AdtsIndex
+{
+    int rate = 0;
+    int64_t blocks = 0;
+    Index<AdtsIndexEntry> entries;
+
+    int length () const
+        { return rate ? blocks * 1024 * 1000 / rate : -1; }
+};
+
+struct AdtsIndexCacheHeader
+{
+    int64_t blocks;
+    int32_t rate;
+    int32_t n_entries;
+};
+
+/* Parses the ADTS header at <buf> (at least 7 bytes).  Returns the length of
+ * the frame or 0. */
+static int parse_adts_header (const unsigned char * buf, int * rate, int * blocks)
+{
+    int unused;
+    int length = aac_parse_frame ((unsigned char *) buf, rate, & unused);
+
+    if (length < 7)
+        return 0;
+
+    * blocks = (buf[6] & 0x03) + 1;
+    return length;
+}
+
+static int64_t skip_id3 (VFSFile & file)
+{
+    unsigned char buf[10];
+
+    if (file.fseek (0, VFS_SEEK_SET) || file.fread (buf, 1, 10) != 10 ||
+     strncmp ((char *) buf, "ID3", 3))
+        return 0;
+
+    return 10 + (buf[6] << 21) + (buf[7] << 14) + (buf[8] << 7) + buf[9];
+}
+
+static bool build_index (VFSFile & file, AdtsIndex & index, const std::atomic<bool> * abort)
+{
+    unsigned char buf[INDEX_CHUNK];
+    int64_t pos = skip_id3 (file);
+    int64_t frames = 0;
+    int filled = 0, at = 0;
+
+    index.rate = 0;
+    index.blocks = 0;
+    index.entries.clear ();
+
+    while (! * abort)
+    {
+        if (at > filled - 7)
+        {
+            pos += at;
+            at = 0;
+
+            if (file.fseek (pos, VFS_SEEK_SET) ||
+             (filled = file.fread (buf, 1, sizeof buf)) < 7)
+                break;
+        }
+
+        int rate, blocks;
+        int length = parse_adts_header (buf + at, & rate, & blocks);
+
+        /* skip leading junk, but stop at the first bad frame after that */
+        if (! length || (index.rate && rate != index.rate))
+        {
+            if (frames || pos + at > INDEX_CHUNK)
+                break;
+
+            at ++;
+            continue;
+        }
+
+        if (! (frames % INDEX_STEP))
+            index.entries.append (AdtsIndexEntry {pos + at, index.blocks});
+
+        index.rate = rate;
+        index.blocks += blocks;
+        frames ++;
+
+        at += length;
+    }
+
+    AUDDBG ("Indexed %ld ADTS frames.\n", (long) frames);
+    return ! * abort && frames;
+}
+
+static bool load_index (const char * filename, VFSFile & file, AdtsIndex & index)
+{
+    int64_t size = file.fsize ();
+    if (size < 0)
+        return false;
+
+    Index<char> data;
+    AdtsIndexCacheHeader header;
+
+    if (! index_cache.load (filename, size, data) || data.len () < (int) sizeof header)
+        return false;
+
+    memcpy (& header, data.begin (), sizeof header);
+
+    if (header.rate <= 0 || header.n_entries < 0 ||
+     header.n_entries > (int) (data.len () / sizeof (AdtsIndexEntry)) ||
+     (size_t) data.len () != sizeof header + header.n_entries * sizeof (AdtsIndexEntry))
+        return false;
+
+    index.rate = header.rate;
+    index.blocks = header.blocks;
+    index.entries.clear ();
+    index.entries.insert ((const AdtsIndexEntry *) (data.begin () + sizeof header),
+     0, header.n_entries);
+
+    return true;
+}
+
+static void save_index (const char * filename, int64_t size, const AdtsIndex & index)
+{
+    AdtsIndexCacheHeader header = AdtsIndexCacheHeader ();
+    header.blocks = index.blocks;
+    header.rate = index.rate;
+    header.n_entries = index.entries.len ();
+
+    Index<char> data;
+    disk_cache_append (data, & header, 1);
+    disk_cache_append (data, index.entries.begin (), index.entries.len ());
+
+    index_cache.save (filename, size, data);
+}
+
+class AdtsIndexer
+{
+public:
+    ~AdtsIndexer ()
+        { stop (); }
+
+    void start (const char * filename)
+    {
+        m_filename = String (filename);
+        m_abort = false;
+        m_done = false;
+        m_running = ! pthread_create (& m_thread, nullptr, run, this);
+    }
+
+    void stop ()
+    {
+        if (! m_running)
+            return;
+
+        m_abort = true;
+        pthread_join (m_thread, nullptr);
+        m_running = false;
+    }
+
+    /* Returns true once, when the index has been completed. */
+    bool poll (AdtsIndex & index)
+    {
+        pthread_mutex_lock (& m_mutex);
+        bool done = m_done;
+        m_done = false;
+
+        if (done)
+            index = std::move (m_index);
+
+        pthread_mutex_unlock (& m_mutex);
+        return done;
+    }
+
+private:
+    static void * run (void * data)
+    {
+        auto self = (AdtsIndexer *) data;
+        VFSFile file (self->m_filename, "r");
+        AdtsIndex index;
+
+        if (file && build_index (file, index, & self->m_abort))
+        {
+            save_index (self->m_filename, file.fsize (), index);
+
+            pthread_mutex_lock (& self->m_mutex);
+            self->m_index = std::move (index);
+            self->m_done = true;
+            pthread_mutex_unlock (& self->m_mutex);
+        }
+
+        return nullptr;
+    }
+
+    String m_filename;
+    pthread_t m_thread;
+    pthread_mutex_t m_mutex = PTHREAD_MUTEX_INITIALIZER;
+    std::atomic<bool> m_abort {false};
+    bool m_running = false, m_done = false;
+    AdtsIndex m_index;
+};
+
 bool AACDecoder::read_tag (const char * filename, VFSFile & file, Tuple & tuple,
  Index<char> * image)
 {
     int length, bitrate, samplerate, channels;
+    AdtsIndex index;
 
     tuple.set_str (Tuple::Codec, "MPEG-2/4 AAC");
 
-    // TODO: error handling
-    calc_aac_info (file, &length, &bitrate, &samplerate, &channels);
+    if (load_index (filename, file, index))
+    {
+        length = index.length ();
+        bitrate = (length > 0) ? file.fsize () * 8 / length : -1;
+    }
+    else
+    {
+        // TODO: error handling
+        calc_aac_info (file, &length, &bitrate, &samplerate, &channels);
+    }
 
     if (length > 0)
         tuple.set_int (Tuple::Length, length);
@@ -275,8 +509,48 @@ bool AACDecoder::read_tag (const char * filename, VFSFile & file, Tuple & tuple,
     return true;
 }
 
+/* Finds the offset of the ADTS frame containing <time> (in milliseconds). */
+static int64_t find_frame_offset (VFSFile & file, const AdtsIndex & index, int time)
+{
+    int64_t target = (int64_t) time * index.rate / 1000 / 1024;
+    int low = 0, high = index.entries.len ();
+
+    while (high - low > 1)
+    {
+        int mid = (low + high) / 2;
+
+        if (index.entries[mid].block <= target)
+            low = mid;
+        else
+            high = mid;
+    }
+
+    if (! index.entries.len ())
+        return -1;
+
+    int64_t offset = index.entries[low].offset;
+    int64_t block = index.entries[low].block;
+
+    /* walk the remaining (fewer than INDEX_STEP) headers */
+    for (int i = 0; i < INDEX_STEP; i ++)
+    {
+        unsigned char header[7];
+        int rate, blocks, length;
+
+        if (file.fseek (offset, VFS_SEEK_SET) || file.fread (header, 1, 7) != 7 ||
+         ! (length = parse_adts_header (header, & rate, & blocks)) ||
+         block + blocks > target)
+            break;
+
+        offset += length;
+        block += blocks;
+    }
+
+    return offset;
+}
+
 static void aac_seek (VFSFile & file, NeAACDecHandle dec, int time, int len,
- void * buf, int size, int * buflen)
+ const AdtsIndex * index, void * buf, int size, int * buflen)
 {
     /* == ESTIMATE BYTE OFFSET == */
 
@@ -287,9 +561,13 @@ static void aac_seek (VFSFile & file, NeAACDecHandle dec, int time, int len,
         return;
     }
 
+    int64_t offset = index ? find_frame_offset (file, * index, time) : -1;
+    if (offset < 0)
+        offset = total * time / len;
+
     /* == SEEK == */
 
-    if (file.fseek (total * time / len, VFS_SEEK_SET))
+    if (file.fseek (offset, VFS_SEEK_SET))
         return;
 
     * buflen = file.fread (buf, 1, size);
@@ -335,6 +613,14 @@ bool AACDecoder::play (const char * filename, VFSFile & file)
     Tuple tuple = get_playback_tuple ();
     int bitrate = 1000 * aud::max (0, tuple.get_int (Tuple::Bitrate));
 
+    AdtsIndex index;
+    AdtsIndexer indexer;
+    bool have_index = load_index (filename, file, index);
+
+    /* reading a stream twice would mean downloading it twice */
+    if (! have_index && file.fsize () > 0 && uri_to_filename (filename))
+        indexer.start (filename);
+
     if ((decoder = NeAACDecOpen ()) == nullptr)
     {
         AUDERR ("Open Decoder Error\n");
@@ -408,6 +694,19 @@ bool AACDecoder::play (const char * filename, VFSFile & file)
 
     while (! check_stop ())
     {
+        /* == PICK UP THE FRAME INDEX == */
+
+        if (! have_index && indexer.poll (index))
+        {
+            have_index = true;
+
+            if (index.length () > 0)
+            {
+                tuple.set_int (Tuple::Length, index.length ());
+                set_playback_tuple (tuple.ref ());
+            }
+        }
+
         /* == HANDLE SEEK REQUESTS == */
 
         int seek_value = check_seek ();
@@ -416,7 +715,8 @@ bool AACDecoder::play (const char * filename, VFSFile & file)
         {
             int length = tuple.get_int (Tuple::Length);
             if (length > 0)
-                aac_seek (file, decoder, seek_value, length, buf, sizeof buf, & buflen);
+                aac_seek (file, decoder, seek_value, length,
+                 have_index ? & index : nullptr, buf, sizeof buf, & buflen);
         }
 
         /* == CHECK FOR END OF FILE == */
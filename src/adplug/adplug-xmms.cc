@@ -35,6 +35,8 @@
 #include <libaudcore/preferences.h>
 
 #include "adplug-xmms.h"
+#include "../plugin-common/disk-cache.h"
+#include "../plugin-common/output-rate.h"
 
 #define CFG_ID "AdPlug"
 
@@ -123,6 +125,103 @@ dbg_printf (const char *fmt, ...)
 
 #endif
 
+/***** Player selection *****/
+
+/* CAdPlug::factory() offers a file that the players claiming its extension
+ * reject to every other player as well, each one parsing it in turn.  Try
+ * only the former first, unless no player knows the extension at all. */
+static CPlayers players_for (const char * filename)
+{
+  CPlayers list;
+
+  for (const CPlayerDesc * desc : CAdPlug::players)
+  {
+    for (unsigned i = 0; desc->get_extension (i); i ++)
+    {
+      if (CFileProvider::extension (filename, desc->get_extension (i)))
+      {
+        list.push_back (desc);
+        break;
+      }
+    }
+  }
+
+  return list.empty () ? CAdPlug::players : list;
+}
+
+/* Files with a misleading extension still go to every player, as before. */
+static CPlayer * open_player (const char * filename, Copl * opl, const CFileProvider & fp)
+{
+  CPlayers list = players_for (filename);
+  CPlayer * p = CAdPlug::factory (filename, opl, list, fp);
+
+  if (! p && list.size () != CAdPlug::players.size ())
+    p = CAdPlug::factory (filename, opl, CAdPlug::players, fp);
+
+  return p;
+}
+
+/***** Song length cache *****/
+
+/* Measuring the length of a song means playing all of it, so the result is
+ * kept on disk, at most 1 MB of it. */
+
+static DiskCache length_cache ("adplug-lengths", "ADPL", 2, 1 << 20);
+
+struct LengthCacheEntry
+{
+  int32_t subsong;
+  int32_t length;
+};
+
+static void load_lengths (const char * filename, int64_t size,
+ Index<LengthCacheEntry> & entries)
+{
+  Index<char> data;
+
+  if (! length_cache.load (filename, size, data) ||
+   data.len () % sizeof (LengthCacheEntry))
+    return;
+
+  entries.insert ((const LengthCacheEntry *) data.begin (), 0,
+   data.len () / sizeof (LengthCacheEntry));
+}
+
+static void save_lengths (const char * filename, int64_t size,
+ const Index<LengthCacheEntry> & entries)
+{
+  Index<char> data;
+  disk_cache_append (data, entries.begin (), entries.len ());
+
+  length_cache.save (filename, size, data);
+}
+
+/* Only local files are cached, since only their mtime can be checked. */
+static int songlength (const char * filename, VFSFile & file, CPlayer * p,
+ unsigned int subsong)
+{
+  int64_t size = file.fsize ();
+
+  if (size < 0 || ! uri_to_filename (filename))
+    return p->songlength (subsong);
+
+  Index<LengthCacheEntry> entries;
+  load_lengths (filename, size, entries);
+
+  for (const LengthCacheEntry & entry : entries)
+  {
+    if (entry.subsong == (int32_t) subsong)
+      return entry.length;
+  }
+
+  int length = p->songlength (subsong);
+
+  entries.append (LengthCacheEntry {(int32_t) subsong, length});
+  save_lengths (filename, size, entries);
+
+  return length;
+}
+
 /***** Main player (!! threaded !!) *****/
 
 bool AdPlugXMMS::read_tag (const char * filename, VFSFile & file, Tuple & tuple,
@@ -131,7 +230,7 @@ bool AdPlugXMMS::read_tag (const char * filename, VFSFile & file, Tuple & tuple,
   CSilentopl tmpopl;
 
   CFileVFSProvider fp (file);
-  CPlayer *p = CAdPlug::factory (filename, &tmpopl, CAdPlug::players, fp);
+  CPlayer *p = open_player (filename, &tmpopl, fp);
 
   if (! p)
     return false;
@@ -146,12 +245,20 @@ bool AdPlugXMMS::read_tag (const char * filename, VFSFile & file, Tuple & tuple,
 
   tuple.set_str (Tuple::Codec, p->gettype().c_str());
   tuple.set_str (Tuple::Quality, _("sequenced"));
-  tuple.set_int (Tuple::Length, p->songlength (plr.subsong));
+  tuple.set_int (Tuple::Length, songlength (filename, file, p, plr.subsong));
   delete p;
 
   return true;
 }
 
+/* If a resampling effect is enabled, the OPL emulator might as well run at
+ * the rate that effect converts to; otherwise use the configured rate. */
+static int output_rate (int freq)
+{
+  int rate = effect_output_rate (freq);
+  return (rate >= 8000 && rate <= 192000) ? rate : freq;
+}
+
 /* Main playback thread. Takes the filename to play as argument. */
 bool AdPlugXMMS::play (const char * filename, VFSFile & fd)
 {
@@ -159,7 +266,7 @@ bool AdPlugXMMS::play (const char * filename, VFSFile & fd)
 
   bool bit16 = aud_get_bool (CFG_ID, "16bit");
   bool stereo = aud_get_bool (CFG_ID, "Stereo");
-  int freq = aud_get_int (CFG_ID, "Frequency");
+  int freq = output_rate (aud_get_int (CFG_ID, "Frequency"));
   bool endless = aud_get_bool (CFG_ID, "Endless");
 
   // Set XMMS main window information
@@ -179,7 +286,7 @@ bool AdPlugXMMS::play (const char * filename, VFSFile & fd)
   // Try to load module
   dbg_printf ("factory, ");
   CFileVFSProvider fp (fd);
-  if (!(plr.p = CAdPlug::factory (filename, &opl, CAdPlug::players, fp)))
+  if (!(plr.p = open_player (filename, &opl, fp)))
   {
     dbg_printf ("error!\n");
     // MessageBox("AdPlug :: Error", "File could not be opened!", "Ok");
@@ -269,7 +376,7 @@ bool AdPlugXMMS::is_our_file (const char * filename, VFSFile & fd)
   CSilentopl tmpopl;
 
   CFileVFSProvider fp (fd);
-  CPlayer *p = CAdPlug::factory (filename, &tmpopl, CAdPlug::players, fp);
+  CPlayer *p = open_player (filename, &tmpopl, fp);
 
   dbg_printf ("adplug_is_our_file(\"%s\"): returned ", filename);
 
@@ -0,0 +1 @@
+#include "../plugin-common/output-rate.cc"
@@ -30,6 +30,7 @@
 #include "i_configure.h"
 #include "i_fileinfo.h"
 #include "i_midi.h"
+#include "../plugin-common/output-rate.h"
 
 class AMIDIPlug : public InputPlugin
 {
@@ -63,6 +64,7 @@ public:
 
 protected:
     bool m_backend_initialized = false;
+    int m_backend_rate = 0;
 
     static bool audio_init ();
     static void audio_generate (double seconds);
@@ -196,10 +198,23 @@ void AMIDIPlug::audio_cleanup ()
     delete[] s_buf;
 }
 
+/* If a resampler is going to convert our output anyway, synthesize
+ * directly at its target rate instead. */
+static int synth_rate ()
+{
+    int rate = aud_get_int ("amidiplug", "fsyn_synth_samplerate");
+    int target = effect_output_rate (rate);
+
+    /* FluidSynth accepts 22050 to 96000 Hz */
+    return (target >= 22050 && target <= 96000) ? target : rate;
+}
+
 bool AMIDIPlug::play (const char * filename, VFSFile & file)
 {
-    if (__sync_bool_compare_and_swap (& backend_settings_changed, true, false)
-     && m_backend_initialized)
+    int rate = synth_rate ();
+
+    if ((__sync_bool_compare_and_swap (& backend_settings_changed, true, false)
+     || rate != m_backend_rate) && m_backend_initialized)
     {
         AUDDBG ("Settings changed, reinitializing backend\n");
         backend_cleanup ();
@@ -208,8 +223,9 @@ bool AMIDIPlug::play (const char * filename, VFSFile & file)
 
     if (! m_backend_initialized)
     {
-        backend_init ();
+        backend_init (rate);
         m_backend_initialized = true;
+        m_backend_rate = rate;
     }
 
     if (! audio_init ())
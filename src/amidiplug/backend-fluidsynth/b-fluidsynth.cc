@@ -36,6 +36,7 @@ typedef struct
 {
     fluid_settings_t * settings;
     fluid_synth_t * synth;
+    int samplerate;
 
     Index<int> soundfont_ids;
 }
@@ -47,12 +48,12 @@ static sequencer_client_t sc;
 
 static void i_soundfont_load ();
 
-void backend_init ()
+void backend_init (int samplerate)
 {
     sc.settings = new_fluid_settings();
+    sc.samplerate = samplerate;
 
-    fluid_settings_setnum (sc.settings, "synth.sample-rate",
-     aud_get_int ("amidiplug", "fsyn_synth_samplerate"));
+    fluid_settings_setnum (sc.settings, "synth.sample-rate", samplerate);
 
     int gain = aud_get_int ("amidiplug", "fsyn_synth_gain");
     int polyphony = aud_get_int ("amidiplug", "fsyn_synth_polyphony");
@@ -196,7 +197,7 @@ void backend_audio_info (int * channels, int * bitdepth, int * samplerate)
 {
     *channels = 2;
     *bitdepth = 16; /* always 16 bit, we use fluid_synth_write_s16() */
-    *samplerate = aud_get_int ("amidiplug", "fsyn_synth_samplerate");
+    *samplerate = sc.samplerate;
 }
 
 
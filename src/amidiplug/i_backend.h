@@ -23,7 +23,7 @@
 
 struct midievent_t;
 
-void backend_init ();
+void backend_init (int samplerate);
 void backend_cleanup ();
 void backend_reset ();
 
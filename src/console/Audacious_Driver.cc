@@ -8,19 +8,39 @@
 
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <libaudcore/audstrings.h>
 #include <libaudcore/runtime.h>
 
 #include "configure.h"
+#include "length_cache.h"
 #include "plugin.h"
 #include "Music_Emu.h"
 #include "Gzip_Reader.h"
+#include "../plugin-common/output-rate.h"
 
 static const int fade_threshold = 10 * 1000;
 static const int fade_length    = 8 * 1000;
 
+// length detection: stop after this long and treat the track as endless;
+// detected tracks get a short fade over the silence that follows them
+static const int detect_limit     = 10 * 60 * 1000;
+static const int detect_tail      = 1000;
+static const int detect_threshold = 0x10;
+
+// loop detection: the output is reduced to the loudness and the number of
+// zero crossings (roughly, the pitch) of each channel per block, and the
+// track is taken to loop once the last loop_window blocks (or a whole loop,
+// if longer) match the output one loop length earlier
+static const int loop_block_rate  = 50;     // blocks per second
+static const int loop_min         = 5 * loop_block_rate;
+static const int loop_window      = 30 * loop_block_rate;
+static const int loop_check       = 10 * loop_block_rate;
+static const int loop_quiet       = 32;     // loudness() of detect_threshold
+static const int loop_hysteresis  = 0x100;  // ignored around zero
+
 static bool log_err(blargg_err_t err)
 {
     if (err)
@@ -144,13 +164,20 @@ int ConsoleFileHandler::load(int sample_rate)
     return 0;
 }
 
-static int get_track_length(const track_info_t &info)
+static bool is_untimed(const track_info_t &info)
+{
+    return info.length <= 0 && info.intro_length + 2 * info.loop_length <= 0;
+}
+
+static int get_track_length(const track_info_t &info, int detected)
 {
     int length = info.length;
     if (length <= 0)
         length = info.intro_length + 2 * info.loop_length;
 
-    if (length <= 0)
+    if (length <= 0 && detected > 0)
+        length = detected + detect_tail;
+    else if (length <= 0)
         length = audcfg.loop_length * 1000;
     else if (length >= fade_threshold)
         length += fade_length;
@@ -158,6 +185,17 @@ static int get_track_length(const track_info_t &info)
     return length;
 }
 
+// a loop found by the analysis is used like one given in the file
+static int apply_detected(track_info_t &info, const TrackLength &detected)
+{
+    if (detected.loop <= 0)
+        return detected.length;
+
+    info.intro_length = detected.length - 2 * detected.loop;
+    info.loop_length = detected.loop;
+    return LENGTH_UNKNOWN;
+}
+
 bool ConsolePlugin::read_tag(const char *filename, VFSFile &file, Tuple &tuple, Index<char> *image)
 {
     ConsoleFileHandler fh(filename, file);
@@ -191,14 +229,24 @@ bool ConsolePlugin::read_tag(const char *filename, VFSFile &file, Tuple &tuple,
     else
         tuple.set_subtunes(info.track_count, nullptr);
 
-    tuple.set_int (Tuple::Length, get_track_length (info));
+    int detected = LENGTH_UNKNOWN;
+    if (audcfg.detect_length && is_untimed(info))
+    {
+        TrackLength found = length_cache_lookup(fh.m_path, file.fsize(), fh.m_track < 0 ? 0 : fh.m_track);
+        if (found.length == LENGTH_UNKNOWN)
+            length_cache_queue(fh.m_path);
+
+        detected = apply_detected(info, found);
+    }
+
+    tuple.set_int (Tuple::Length, get_track_length (info, detected));
 
     return true;
 }
 
 bool ConsolePlugin::play(const char *filename, VFSFile &file)
 {
-    int length, sample_rate;
+    int length, detected, sample_rate;
     track_info_t info;
 
     // identify file
@@ -217,6 +265,12 @@ bool ConsolePlugin::play(const char *filename, VFSFile &file)
         sample_rate = audcfg.resample_rate;
     if (sample_rate == 0)
         sample_rate = 44100;
+    if (!audcfg.resample)
+    {
+        int out_rate = effect_output_rate(sample_rate);
+        if (out_rate >= 8000 && out_rate <= 192000)
+            sample_rate = out_rate;
+    }
 
     // create emulator and load file
     if (fh.load(sample_rate))
@@ -243,12 +297,16 @@ bool ConsolePlugin::play(const char *filename, VFSFile &file)
 
     // get info
     length = -1;
+    detected = LENGTH_UNKNOWN;
     if (!log_err(fh.m_emu->track_info(&info, fh.m_track)))
     {
         if (fh.m_type == gme_spc_type && audcfg.ignore_spc_length)
             info.length = -1;
 
-        length = get_track_length(info);
+        if (audcfg.detect_length && is_untimed(info))
+            detected = apply_detected(info, length_cache_lookup(fh.m_path, file.fsize(), fh.m_track));
+
+        length = get_track_length(info, detected);
         set_stream_bitrate(fh.m_emu->voice_count() * 1000);
     }
 
@@ -261,11 +319,16 @@ bool ConsolePlugin::play(const char *filename, VFSFile &file)
     open_audio(FMT_S16_NE, sample_rate, 2);
 
     // set fade time
-    if (length <= 0)
-        length = audcfg.loop_length * 1000;
-    if (length >= fade_threshold + fade_length)
-        length -= fade_length / 2;
-    fh.m_emu->set_fade(length, fade_length);
+    if (detected > 0)
+        fh.m_emu->set_fade(detected, detect_tail);
+    else
+    {
+        if (length <= 0)
+            length = audcfg.loop_length * 1000;
+        if (length >= fade_threshold + fade_length)
+            length -= fade_length / 2;
+        fh.m_emu->set_fade(length, fade_length);
+    }
 
     while (!check_stop())
     {
@@ -288,3 +351,212 @@ bool ConsolePlugin::play(const char *filename, VFSFile &file)
 
     return true;
 }
+
+struct LoopBlock
+{
+    unsigned char left, right;              // loudness
+    unsigned char left_cross, right_cross;  // zero crossings
+};
+
+// 8 steps per doubling of the average amplitude
+static unsigned char loudness(long sum, int frames)
+{
+    return (unsigned char) (8 * log2(1.0 + (double) sum / frames));
+}
+
+// counts a crossing only once the signal is clear of the noise floor
+static void count_crossing(Music_Emu::sample_t sample, Music_Emu::sample_t &prev, int &count)
+{
+    if ((prev > 0 && sample < -loop_hysteresis) || (prev <= 0 && sample > loop_hysteresis))
+    {
+        prev = sample;
+        count ++;
+    }
+}
+
+// noisy channels vary by about the square root of the count
+static bool crossings_match(int a, int b)
+{
+    return (a - b) * (a - b) <= 4 + 2 * aud::max(a, b);
+}
+
+static bool blocks_match(const LoopBlock &a, const LoopBlock &b)
+{
+    return abs(a.left - b.left) <= 3 && abs(a.right - b.right) <= 3 &&
+     crossings_match(a.left_cross, b.left_cross) &&
+     crossings_match(a.right_cross, b.right_cross);
+}
+
+// Block <i> repeats <loop> blocks earlier. The loop is rarely a whole number
+// of blocks, so it may match either of the two blocks it straddles or a blend.
+static bool repeats(const Index<LoopBlock> &blocks, int i, int loop)
+{
+    const LoopBlock &a = blocks[i - loop], &b = blocks[i - loop - 1];
+    LoopBlock mid = {
+        (unsigned char) ((a.left + b.left + 1) / 2),
+        (unsigned char) ((a.right + b.right + 1) / 2),
+        (unsigned char) ((a.left_cross + b.left_cross + 1) / 2),
+        (unsigned char) ((a.right_cross + b.right_cross + 1) / 2)
+    };
+
+    return blocks_match(blocks[i], a) || blocks_match(blocks[i], b) ||
+     blocks_match(blocks[i], mid);
+}
+
+// Returns the length (in blocks) of the shortest loop that the output ends
+// with, or 0. Some blocks of each window are allowed to differ, since noise
+// channels and sound effects do not repeat exactly.
+static int find_loop(const Index<LoopBlock> &blocks)
+{
+    int n = blocks.len();
+
+    for (int loop = loop_min; ; loop ++)
+    {
+        int window = aud::max(loop_window, loop);
+        if (window + loop + 1 > n)
+            return 0;
+
+        int misses = 0, loud = 0, i;
+
+        for (i = n - 1; i >= n - window; i --)
+        {
+            if (!repeats(blocks, i, loop) && ++ misses > window / 6)
+                break;
+            if (blocks[i].left > loop_quiet || blocks[i].right > loop_quiet)
+                loud ++;
+        }
+
+        // a quiet stretch matches at any offset, so it proves nothing
+        if (i < n - window && loud >= window / 4)
+            return loop;
+    }
+}
+
+// Walks back from the end until more than half of the last 16 blocks stop
+// repeating, and returns the first block of the first pass through the loop.
+static int find_loop_start(const Index<LoopBlock> &blocks, int loop)
+{
+    int start = blocks.len() - loop, misses = 0;
+    bool recent[16] = {};
+
+    for (int i = start - 1; i > 0; i --)
+    {
+        bool &miss = recent[i % 16];
+        misses -= miss;
+        miss = !repeats(blocks, i + loop, loop);
+        misses += miss;
+
+        if (misses > 8)
+            break;
+        if (!miss)
+            start = i;
+    }
+
+    return start;
+}
+
+// Renders every untimed track of a file without any output, as fast as the
+// emulator runs, and notes where the last sound was when the silence detector
+// (or the emulator itself) ended the track, or where the track started over
+// if it loops. Called from the worker threads.
+bool console_detect_lengths(const char *path, int64_t &size,
+ Index<TrackLength> &lengths, const std::atomic<bool> *abort)
+{
+    VFSFile file(path, "r");
+    if (!file)
+        return false;
+
+    size = file.fsize();
+
+    ConsoleFileHandler fh(path, file);
+    if (!fh.m_type)
+        return false;
+
+    // SPC runs at its native rate to stay clear of the resampler
+    int sample_rate = (fh.m_type == gme_spc_type) ? 32000 : 22050;
+    if (fh.load(sample_rate))
+        return false;
+
+    // each track is played through once, so seeking snapshots are wasted
+    fh.m_emu->disable_snapshots();
+
+    int const buf_size = 1024;
+    Music_Emu::sample_t buf[buf_size];
+    long limit = (long) sample_rate * 2 * (detect_limit / 1000);
+    int const block_frames = sample_rate / loop_block_rate;
+
+    for (int track = 0; track < fh.m_emu->track_count(); track ++)
+    {
+        track_info_t info;
+        if (log_err(fh.m_emu->track_info(&info, track)) || !is_untimed(info))
+        {
+            lengths.append(TrackLength {LENGTH_UNKNOWN, 0});
+            continue;
+        }
+
+        if (log_err(fh.m_emu->start_track(track)))
+        {
+            lengths.append(TrackLength {LENGTH_ENDLESS, 0});
+            continue;
+        }
+
+        long played = 0, last_sound = 0;
+        Index<LoopBlock> blocks;
+        long sum_left = 0, sum_right = 0;
+        int cross_left = 0, cross_right = 0;
+        Music_Emu::sample_t prev_left = 0, prev_right = 0;
+        int frames = 0, loop = 0;
+
+        while (!fh.m_emu->track_ended() && played < limit && !loop)
+        {
+            if (*abort)
+                return false;
+
+            fh.m_emu->play(buf_size, buf);
+
+            for (int i = buf_size; i --; )
+            {
+                if (buf[i] > detect_threshold || buf[i] < -detect_threshold)
+                {
+                    last_sound = played + i + 1;
+                    break;
+                }
+            }
+
+            for (int i = 0; i < buf_size; i += 2)
+            {
+                sum_left += abs(buf[i]);
+                sum_right += abs(buf[i + 1]);
+                count_crossing(buf[i], prev_left, cross_left);
+                count_crossing(buf[i + 1], prev_right, cross_right);
+
+                if (++ frames < block_frames)
+                    continue;
+
+                blocks.append(LoopBlock {loudness(sum_left, frames), loudness(sum_right, frames),
+                 (unsigned char) aud::min(cross_left, 255), (unsigned char) aud::min(cross_right, 255)});
+                sum_left = sum_right = 0;
+                cross_left = cross_right = 0;
+                frames = 0;
+
+                if (!loop && blocks.len() % loop_check == 0)
+                    loop = find_loop(blocks);
+            }
+
+            played += buf_size;
+        }
+
+        if (loop)
+        {
+            int start = find_loop_start(blocks, loop);
+            lengths.append(TrackLength {(start + 2 * loop) * 1000 / loop_block_rate,
+             loop * 1000 / loop_block_rate});
+        }
+        else if (fh.m_emu->track_ended())
+            lengths.append(TrackLength {aud::max(1, (int) ((int64_t) last_sound / 2 * 1000 / sample_rate)), 0});
+        else
+            lengths.append(TrackLength {LENGTH_ENDLESS, 0});
+    }
+
+    return true;
+}
@@ -203,8 +203,9 @@ void Blip_Synth_Fast_::volume_unit( double new_unit )
 
 #if !BLIP_BUFFER_FAST
 
-Blip_Synth_::Blip_Synth_( short* p, int w ) :
+Blip_Synth_::Blip_Synth_( short* p, int w, short* ph ) :
 	impulses( p ),
+	phases( ph ),
 	width( w )
 {
 	volume_unit_ = 0.0;
@@ -302,6 +303,27 @@ void Blip_Synth_::adjust_impulse()
 	//for ( int i = blip_res; i--; printf( "\n" ) )
 	//  for ( int j = 0; j < width / 2; j++ )
 	//      printf( "%5ld,", impulses [j * blip_res + i + 1] );
+
+	update_phases();
+}
+
+// Lay out the taps for each phase in the order offset_resampled() adds them
+// to the buffer: the first half of the kernel forward, the second reversed.
+void Blip_Synth_::update_phases()
+{
+	if ( !phases )
+		return;
+
+	int const half = width / 2;
+	for ( int phase = 0; phase < blip_res; phase++ )
+	{
+		short* out = phases + phase * width;
+		for ( int i = 0; i < half; i++ )
+		{
+			out [i]             = impulses [blip_res - phase + blip_res * i];
+			out [width - 1 - i] = impulses [phase + blip_res * i];
+		}
+	}
 }
 
 void Blip_Synth_::treble_eq( blip_eq_t const& eq )
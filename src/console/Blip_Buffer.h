@@ -137,6 +137,20 @@ private:
 	#endif
 #endif
 
+// Use SSE2 to add impulses and to read stereo buffers. Each synth keeps a second
+// copy of its impulses, rearranged so that the taps for a phase are adjacent.
+#ifndef BLIP_BUFFER_SSE2
+	#if defined (__SSE2__)
+		#define BLIP_BUFFER_SSE2 1
+	#else
+		#define BLIP_BUFFER_SSE2 0
+	#endif
+#endif
+
+#if BLIP_BUFFER_SSE2
+	#include <emmintrin.h>
+#endif
+
 	// Internal
 	typedef blip_ulong blip_resampled_time_t;
 	int const blip_widest_impulse_ = 16;
@@ -162,15 +176,17 @@ private:
 		int delta_factor;
 
 		void volume_unit( double );
-		Blip_Synth_( short* impulses, int width );
+		Blip_Synth_( short* impulses, int width, short* phases = 0 );
 		void treble_eq( blip_eq_t const& );
 	private:
 		double volume_unit_;
 		short* const impulses;
+		short* const phases; // [blip_res] [width], copy of impulses in output order
 		int const width;
 		blip_long kernel_unit;
 		int impulses_size() const { return blip_res / 2 * width + 1; }
 		void adjust_impulse();
+		void update_phases();
 	};
 
 // Quality level. Start with blip_good_quality.
@@ -224,9 +240,15 @@ private:
 	Blip_Synth_ impl;
 	typedef short imp_t;
 	imp_t impulses [blip_res * (quality / 2) + 1];
+#if BLIP_BUFFER_SSE2
+	imp_t phases [blip_res] [quality];
+public:
+	Blip_Synth() : impl( impulses, quality, phases [0] ) { }
+#else
 public:
 	Blip_Synth() : impl( impulses, quality ) { }
 #endif
+#endif
 };
 
 // Low-pass equalization parameters
@@ -352,6 +374,33 @@ inline void Blip_Synth<quality,range>::offset_resampled( blip_resampled_time_t t
 
 	buf [0] = left;
 	buf [1] = right;
+#elif BLIP_BUFFER_SSE2
+
+	// 32x16-bit multiply built from 16-bit halves of delta; the low half is
+	// unsigned, so the signed high product needs the kernel added back when
+	// its top bit is set
+	buf += (blip_widest_impulse_ - quality) / 2;
+	imp_t const* BLIP_RESTRICT imp = phases [phase];
+	__m128i const lo = _mm_set1_epi16( (short) (delta & 0xFFFF) );
+	__m128i const hi = _mm_set1_epi16( (short) (delta >> 16) );
+	__m128i const lo_sign = _mm_srai_epi16( lo, 15 );
+
+	for ( int i = 0; i < quality; i += 8 )
+	{
+		__m128i k = (quality - i >= 8) ? _mm_loadu_si128( (__m128i const*) (imp + i) )
+				: _mm_loadl_epi64( (__m128i const*) (imp + i) );
+		__m128i prod_lo = _mm_mullo_epi16( k, lo );
+		__m128i prod_hi = _mm_add_epi16( _mm_mulhi_epi16( k, lo ),
+				_mm_add_epi16( _mm_and_si128( k, lo_sign ), _mm_mullo_epi16( k, hi ) ) );
+
+		__m128i* out = (__m128i*) (buf + i);
+		_mm_storeu_si128( out, _mm_add_epi32( _mm_loadu_si128( out ),
+				_mm_unpacklo_epi16( prod_lo, prod_hi ) ) );
+		if ( quality - i >= 8 )
+			_mm_storeu_si128( out + 1, _mm_add_epi32( _mm_loadu_si128( out + 1 ),
+					_mm_unpackhi_epi16( prod_lo, prod_hi ) ) );
+	}
+
 #else
 
 	int const fwd = (blip_widest_impulse_ - quality) / 2;
@@ -95,6 +95,16 @@ blargg_err_t Classic_Emu::start_track_( int track )
 	return 0;
 }
 
+long Classic_Emu::buffered_samples_() const
+{
+	return buf->samples_avail();
+}
+
+void Classic_Emu::state_loaded_()
+{
+	buf->clear();
+}
+
 blargg_err_t Classic_Emu::play_( long count, sample_t* out )
 {
 	long remain = count;
@@ -32,6 +32,8 @@ protected:
 	void mute_voices_( int );
 	void set_equalizer_( equalizer_t const& );
 	blargg_err_t play_( long, sample_t* );
+	long buffered_samples_() const;
+	void state_loaded_();
 private:
 	Multi_Buffer* buf;
 	Multi_Buffer* stereo_buffer; // nullptr if using custom buffer
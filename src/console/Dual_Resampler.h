@@ -21,6 +21,9 @@ public:
 
 	void dual_play( long count, dsample_t* out, Blip_Buffer& );
 
+	// Number of samples left over from the last frame
+	long samples_avail() const { return sample_buf_size - buf_pos; }
+
 protected:
 	virtual int play_frame( blip_time_t, int pcm_count, dsample_t* pcm_out ) = 0;
 private:
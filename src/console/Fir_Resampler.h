@@ -7,6 +7,18 @@
 #include "blargg_common.h"
 #include <string.h>
 
+#ifndef FIR_RESAMPLER_SSE2
+	#if defined (__SSE2__)
+		#define FIR_RESAMPLER_SSE2 1
+	#else
+		#define FIR_RESAMPLER_SSE2 0
+	#endif
+#endif
+
+#if FIR_RESAMPLER_SSE2
+	#include <emmintrin.h>
+#endif
+
 class Fir_Resampler_ {
 public:
 
@@ -124,7 +136,24 @@ int Fir_Resampler<width>::read( sample_t* out_begin, blargg_long count )
 			if ( count < 0 )
 				break;
 
-			for ( int n = width / 2; n; --n )
+		#if FIR_RESAMPLER_SSE2
+			// regroup input as l0 l1 r0 r1 l2 l3 r2 r3 and taps as p0 p1 p0 p1 p2 p3 p2 p3,
+			// so pmaddwd gives partial sums for left and right in alternate lanes
+			__m128i sum = _mm_setzero_si128();
+			for ( int n = width / 4; n; --n )
+			{
+				__m128i s = _mm_loadu_si128( (__m128i const*) i );
+				s = _mm_shufflehi_epi16( _mm_shufflelo_epi16( s, 0xD8 ), 0xD8 );
+				__m128i p = _mm_loadl_epi64( (__m128i const*) imp );
+				sum = _mm_add_epi32( sum, _mm_madd_epi16( s, _mm_unpacklo_epi32( p, p ) ) );
+				imp += 4;
+				i += 8;
+			}
+			sum = _mm_add_epi32( sum, _mm_srli_si128( sum, 8 ) );
+			l = _mm_cvtsi128_si32( sum );
+			r = _mm_cvtsi128_si32( _mm_srli_si128( sum, 4 ) );
+		#endif
+			for ( int n = (FIR_RESAMPLER_SSE2 ? width % 4 : width) / 2; n; --n )
 			{
 				int pt0 = imp [0];
 				l += pt0 * i [0];
@@ -148,6 +148,66 @@ long Stereo_Buffer::read_samples( blip_sample_t* out, long count )
 	return count * 2;
 }
 
+#if BLIP_BUFFER_SSE2
+
+typedef Blip_Buffer::buf_t_ const* BLIP_RESTRICT blip_reader_t;
+
+// Runs the left, right and center integrators side by side, four samples at a
+// time, with the center added to both sides. Center may be null. Returns the
+// number of samples written, which is a multiple of four.
+static blargg_long mix_stereo_sse2( blip_sample_t* out, blargg_long count, int bass,
+		blip_reader_t& left, blip_reader_t& right, blip_reader_t& center,
+		blip_long& left_accum, blip_long& right_accum, blip_long& center_accum )
+{
+	// lanes: left, right, center, center
+	__m128i accum = _mm_setr_epi32( left_accum, right_accum, center_accum, center_accum );
+	__m128i const shift = _mm_cvtsi32_si128( bass );
+	__m128i c = _mm_setzero_si128();
+
+	blargg_long n = 0;
+	for ( ; n + 4 <= count; n += 4 )
+	{
+		__m128i l = _mm_loadu_si128( (__m128i const*) (left  + n) );
+		__m128i r = _mm_loadu_si128( (__m128i const*) (right + n) );
+		if ( center )
+			c = _mm_loadu_si128( (__m128i const*) (center + n) );
+
+		__m128i lr0 = _mm_unpacklo_epi32( l, r );
+		__m128i lr1 = _mm_unpackhi_epi32( l, r );
+		__m128i cc0 = _mm_unpacklo_epi32( c, c );
+		__m128i cc1 = _mm_unpackhi_epi32( c, c );
+		__m128i in [4] = {
+			_mm_unpacklo_epi64( lr0, cc0 ), _mm_unpackhi_epi64( lr0, cc0 ),
+			_mm_unpacklo_epi64( lr1, cc1 ), _mm_unpackhi_epi64( lr1, cc1 )
+		};
+
+		__m128i s [4];
+		for ( int i = 0; i < 4; i++ )
+		{
+			__m128i v = _mm_srai_epi32( accum, blip_sample_bits - 16 );
+			s [i] = _mm_add_epi32( v, _mm_shuffle_epi32( v, 0xEE ) );
+			accum = _mm_add_epi32( accum, _mm_sub_epi32( in [i], _mm_sra_epi32( accum, shift ) ) );
+		}
+
+		// saturates the same way as the scalar loop, since sums are within 18 bits
+		_mm_storeu_si128( (__m128i*) (out + n * 2), _mm_packs_epi32(
+				_mm_unpacklo_epi64( s [0], s [1] ), _mm_unpacklo_epi64( s [2], s [3] ) ) );
+	}
+
+	left_accum   = _mm_cvtsi128_si32( accum );
+	right_accum  = _mm_cvtsi128_si32( _mm_srli_si128( accum, 4 ) );
+	center_accum = _mm_cvtsi128_si32( _mm_srli_si128( accum, 8 ) );
+
+	left  += n;
+	right += n;
+	if ( center )
+		center += n;
+
+	return n;
+}
+
+#endif
+
 void Stereo_Buffer::mix_stereo( blip_sample_t* out_, blargg_long count )
 {
 	blip_sample_t* BLIP_RESTRICT out = out_;
@@ -156,6 +216,15 @@ void Stereo_Buffer::mix_stereo( blip_sample_t* out_, blargg_long count )
 	BLIP_READER_BEGIN( right, bufs [2] );
 	BLIP_READER_BEGIN( center, bufs [0] );
 
+#if BLIP_BUFFER_SSE2
+	{
+		blargg_long n = mix_stereo_sse2( out, count, bass, left_reader_buf, right_reader_buf,
+				center_reader_buf, left_reader_accum, right_reader_accum, center_reader_accum );
+		out += n * 2;
+		count -= n;
+	}
+#endif
+
 	for ( ; count; --count )
 	{
 		int c = BLIP_READER_READ( center );
@@ -188,6 +257,17 @@ void Stereo_Buffer::mix_stereo_no_center( blip_sample_t* out_, blargg_long count
 	BLIP_READER_BEGIN( left, bufs [1] );
 	BLIP_READER_BEGIN( right, bufs [2] );
 
+#if BLIP_BUFFER_SSE2
+	{
+		blip_reader_t no_center = 0;
+		blip_long no_center_accum = 0;
+		blargg_long n = mix_stereo_sse2( out, count, bass, left_reader_buf, right_reader_buf,
+				no_center, left_reader_accum, right_reader_accum, no_center_accum );
+		out += n * 2;
+		count -= n;
+	}
+#endif
+
 	for ( ; count; --count )
 	{
 		blargg_long l = BLIP_READER_READ( left );
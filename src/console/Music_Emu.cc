@@ -38,6 +38,7 @@ void Music_Emu::clear_track_vars()
 	silence_time     = 0;
 	silence_count    = 0;
 	buf_remain       = 0;
+	next_snapshot    = INT_MAX; // none until init_snapshots()
 	warning(); // clear warning
 }
 
@@ -45,6 +46,10 @@ void Music_Emu::unload()
 {
 	voice_count_ = 0;
 	clear_track_vars();
+	snapshots.clear();
+	snapshot_count = 0;
+	snapshot_track = -1;
+	state_size     = 0;
 	Gme_File::unload();
 }
 
@@ -53,6 +58,9 @@ Music_Emu::Music_Emu()
 	effects_buffer = 0;
 
 	sample_rate_ = 0;
+	snapshot_slots    = 0;
+	snapshot_interval = 0;
+	disable_snapshots_ = false;
 	mute_mask_   = 0;
 	tempo_       = 1.0;
 	gain_        = 1.0;
@@ -93,6 +101,7 @@ void Music_Emu::set_equalizer( equalizer_t const& eq )
 {
 	equalizer_ = eq;
 	set_equalizer_( eq );
+	clear_snapshots(); // they may include filter settings
 }
 
 void Music_Emu::mute_voice( int index, bool mute )
@@ -121,6 +130,7 @@ void Music_Emu::set_tempo( double t )
 	if ( t > max ) t = max;
 	tempo_ = t;
 	set_tempo_( t );
+	clear_snapshots(); // their times assume the old tempo
 }
 
 void Music_Emu::post_load_()
@@ -156,6 +166,7 @@ blargg_err_t Music_Emu::start_track( int track )
 		silence_time  = 0;
 		silence_count = 0;
 	}
+	init_snapshots();
 	return track_ended() ? warning() : 0;
 }
 
@@ -187,8 +198,17 @@ long Music_Emu::tell() const
 blargg_err_t Music_Emu::seek( long msec )
 {
 	blargg_long time = msec_to_samples( msec );
-	if ( time < out_time )
+
+	// resume from latest snapshot at or before time, unless current position is closer
+	int i = (snapshot_track == current_track_) ? snapshot_count : 0;
+	while ( i && snapshot_times [i - 1] > time )
+		i--;
+
+	if ( i && (time < out_time || snapshot_times [i - 1] > out_time) )
+		load_snapshot( i - 1 );
+	else if ( time < out_time )
 		RETURN_ERR( start_track( current_track_ ) );
+
 	return skip( time - out_time );
 }
 
@@ -208,10 +228,17 @@ blargg_err_t Music_Emu::skip( long count )
 		count -= n;
 	}
 
-	if ( count && !emu_track_ended_ )
+	while ( count && !emu_track_ended_ )
 	{
-		emu_time += count;
-		end_track_if_error( skip_( count ) );
+		// stop at each snapshot point along the way
+		long n = count;
+		if ( next_snapshot > emu_time && n > next_snapshot - emu_time )
+			n = next_snapshot - emu_time;
+		count -= n;
+		emu_time += n;
+		end_track_if_error( skip_( n ) );
+		if ( emu_time >= next_snapshot && !emu_track_ended_ )
+			save_snapshot();
 	}
 
 	if ( !(silence_count | buf_remain) ) // caught up to emulator, so update track ended
@@ -249,6 +276,104 @@ blargg_err_t Music_Emu::skip_( long count )
 	return 0;
 }
 
+// Snapshots
+
+static void count_state( unsigned char** io, void*, size_t size )
+{
+	*io = (unsigned char*) ((uintptr_t) *io + size); // *io starts out as 0
+}
+
+static void save_state( unsigned char** io, void* state, size_t size )
+{
+	memcpy( *io, state, size );
+	*io += size;
+}
+
+static void load_state( unsigned char** io, void* state, size_t size )
+{
+	memcpy( state, *io, size );
+	*io += size;
+}
+
+void Music_Emu::init_snapshots()
+{
+	if ( snapshot_track == current_track_ && snapshot_count )
+	{
+		// same track restarted; emulation is deterministic so snapshots still apply
+		next_snapshot = snapshot_times [snapshot_count - 1] + snapshot_interval;
+		return;
+	}
+
+	snapshot_track    = current_track_;
+	snapshot_count    = 0;
+	snapshot_interval = snapshot_period * stereo * sample_rate();
+	state_size        = 0;
+
+	if ( disable_snapshots_ )
+		return;
+
+	byte* end = 0;
+	if ( !copy_state_( &end, count_state ) )
+		return;
+
+	long size = (long) (uintptr_t) end;
+	snapshot_slots = (int) min( (long) max_snapshots, snapshot_mem_limit / size );
+	if ( snapshot_slots < 2 )
+		return;
+
+	if ( snapshots.size() < (size_t) (size * snapshot_slots) &&
+			snapshots.resize( size * snapshot_slots ) )
+		return; // seek the slow way
+
+	state_size = size;
+	save_snapshot(); // so seeking backwards never has to restart the track
+}
+
+void Music_Emu::clear_snapshots()
+{
+	snapshot_count = 0;
+	if ( state_size )
+		next_snapshot = emu_time;
+}
+
+void Music_Emu::save_snapshot()
+{
+	if ( snapshot_count >= snapshot_slots )
+	{
+		// out of room, so keep every other snapshot and take them half as often
+		int n = 0;
+		for ( int i = 0; i < snapshot_count; i += 2 )
+		{
+			snapshot_times [n] = snapshot_times [i];
+			memmove( &snapshots [n * state_size], &snapshots [i * state_size], state_size );
+			n++;
+		}
+		snapshot_count = n;
+		snapshot_interval *= 2;
+	}
+
+	byte* out = &snapshots [snapshot_count * state_size];
+	copy_state_( &out, save_state );
+	snapshot_times [snapshot_count++] = emu_time + buffered_samples_();
+	next_snapshot = emu_time + snapshot_interval;
+}
+
+void Music_Emu::load_snapshot( int i )
+{
+	byte* in = &snapshots [i * state_size];
+	copy_state_( &in, load_state );
+	state_loaded_();
+	remute_voices();
+
+	out_time         = snapshot_times [i];
+	emu_time         = out_time;
+	emu_track_ended_ = false;
+	track_ended_     = false;
+	silence_time     = emu_time;
+	silence_count    = 0;
+	buf_remain       = 0;
+}
+
 // Fading
 
 void Music_Emu::set_fade( long start_msec, long length_msec )
@@ -292,7 +417,11 @@ void Music_Emu::emu_play( long count, sample_t* out )
 	check( current_track_ >= 0 );
 	emu_time += count;
 	if ( current_track_ >= 0 && !emu_track_ended_ )
+	{
 		end_track_if_error( play_( count, out ) );
+		if ( emu_time >= next_snapshot && !emu_track_ended_ )
+			save_snapshot();
+	}
 	else
 		memset( out, 0, count * sizeof *out );
 }
@@ -41,7 +41,8 @@ public:
 	// Number of milliseconds (1000 msec = 1 second) played since beginning of track
 	long tell() const;
 
-	// Seek to new time in track. Seeking backwards or far forward can take a while.
+	// Seek to new time in track. Seeking backwards or far forward can take a while,
+	// unless the emulator supports snapshots and the time has been played before.
 	blargg_err_t seek( long msec );
 
 	// Skip n samples
@@ -57,6 +58,9 @@ public:
 	// Disable automatic end-of-track detection and skipping of silence at beginning
 	void ignore_silence( bool disable = true );
 
+	// Don't keep snapshots for seeking, e.g. when only playing tracks through once
+	void disable_snapshots( bool disable = true );
+
 	// Info for current track
 	using Gme_File::track_info;
 	blargg_err_t track_info( track_info_t* out ) const;
@@ -122,6 +126,16 @@ protected:
 	virtual blargg_err_t start_track_( int ) = 0; // tempo is set before this
 	virtual blargg_err_t play_( long count, sample_t* out ) = 0;
 	virtual blargg_err_t skip_( long count );
+
+	// Pass each block of emulator state to copy(), which either saves or restores
+	// it. Implementing this lets seek() resume from periodic snapshots rather than
+	// emulating from the beginning of the track. Returns false if not supported.
+	virtual bool copy_state_( byte** io, blargg_copy_func_t copy );
+	// Number of samples generated but not yet returned by play_(). A snapshot saved
+	// now is this far ahead of the samples played so far.
+	virtual long buffered_samples_() const { return 0; }
+	// Called after a snapshot has been restored, to discard buffered output
+	virtual void state_loaded_() { }
 protected:
 	virtual void unload();
 	virtual void pre_load();
@@ -164,6 +178,24 @@ private:
 	void fill_buf();
 	void emu_play( long count, sample_t* out );
 
+	// snapshots for seeking, in order of time
+	enum { max_snapshots = 64 };
+	enum { snapshot_mem_limit = 8 * 1024 * 1024L };
+	enum { snapshot_period = 5 }; // initial seconds between snapshots
+	blargg_vector<byte> snapshots;
+	blargg_long snapshot_times [max_snapshots];
+	int snapshot_count;
+	int snapshot_track;    // track snapshots were made for
+	int snapshot_slots;    // number of snapshots that fit in memory limit
+	bool disable_snapshots_;
+	long state_size;       // 0 if emulator doesn't support snapshots
+	blargg_long snapshot_interval;
+	blargg_long next_snapshot;
+	void clear_snapshots();
+	void init_snapshots();
+	void save_snapshot();
+	void load_snapshot( int );
+
 	Multi_Buffer* effects_buffer;
 	friend Music_Emu* gme_new_emu( gme_type_t, int );
 	friend void gme_set_stereo_depth( Music_Emu*, double );
@@ -199,7 +231,9 @@ inline void Music_Emu::enable_accuracy( bool b )    { enable_accuracy_( b ); }
 inline void Music_Emu::set_tempo_( double t )       { tempo_ = t; }
 inline void Music_Emu::remute_voices()              { mute_voices( mute_mask_ ); }
 inline void Music_Emu::ignore_silence( bool b )     { ignore_silence_ = b; }
+inline void Music_Emu::disable_snapshots( bool b )  { disable_snapshots_ = b; }
 inline blargg_err_t Music_Emu::start_track_( int )  { return 0; }
+inline bool Music_Emu::copy_state_( byte**, blargg_copy_func_t ) { return false; }
 
 inline void Music_Emu::set_voice_names( const char* const* names )
 {
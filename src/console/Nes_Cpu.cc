@@ -84,6 +84,17 @@ void Nes_Cpu::reset( void const* unmapped_page )
 	map_code( 0x0000, 0x2000, low_mem, true );
 }
 
+void Nes_Cpu::copy_state( unsigned char** io, blargg_copy_func_t copy )
+{
+	check( state == &state_ );
+	copy( io, low_mem, sizeof low_mem );
+	copy( io, &r, sizeof r );
+	copy( io, &state_, sizeof state_ );
+	copy( io, &irq_time_, sizeof irq_time_ );
+	copy( io, &end_time_, sizeof end_time_ );
+	copy( io, &error_count_, sizeof error_count_ );
+}
+
 void Nes_Cpu::map_code( nes_addr_t start, unsigned size, void const* data, bool mirror )
 {
 	// address range must begin and end on page boundaries
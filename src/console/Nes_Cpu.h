@@ -61,6 +61,9 @@ public:
 	// CPU invokes bad opcode handler if it encounters this
 	enum { bad_opcode = 0xF2 };
 
+	// Save/restore registers, RAM and memory mapping (see blargg_common.h)
+	void copy_state( unsigned char** io, blargg_copy_func_t );
+
 public:
 	Nes_Cpu() { state = &state_; }
 	enum { page_bits = 11 };
@@ -557,3 +557,26 @@ blargg_err_t Nsf_Emu::run_clocks( blip_time_t& duration, int )
 
 	return 0;
 }
+
+bool Nsf_Emu::copy_state_( byte** io, blargg_copy_func_t copy )
+{
+	cpu::copy_state( io, copy );
+	copy( io, sram, sizeof sram );
+	copy( io, &saved_state, sizeof saved_state );
+	copy( io, &next_play, sizeof next_play );
+	copy( io, &play_extra, sizeof play_extra );
+	copy( io, &play_ready, sizeof play_ready );
+
+	// sound chips are copied whole, which is fine since they're only restored
+	// into themselves; remute_voices() then reattaches their outputs
+	copy( io, &apu, sizeof apu );
+	#if !NSF_EMU_APU_ONLY
+	{
+		if ( namco ) copy( io, namco, sizeof *namco );
+		if ( vrc6  ) copy( io, vrc6,  sizeof *vrc6  );
+		if ( fme7  ) copy( io, fme7,  sizeof *fme7  );
+	}
+	#endif
+
+	return true;
+}
@@ -5,6 +5,10 @@
 #include "blargg_endian.h"
 #include <string.h>
 
+#if SPC_DSP_SSE2
+	#include <emmintrin.h>
+#endif
+
 /* Copyright (C) 2007 Shay Green. This module is free software; you
 can redistribute it and/or modify it under the terms of the GNU Lesser
 General Public License as published by the Free Software Foundation; either
@@ -181,6 +185,31 @@ inline void Spc_Dsp::run_counter( int i )
 	(*m.counter_select [rate] & counter_mask [rate])
 
 
+//// SSE2
+
+#if SPC_DSP_SSE2
+
+// Echo FIR over the eight most recent samples, oldest first
+static inline void echo_fir_sse2( int const (*hist) [2], __m128i fir_lo, __m128i fir_hi,
+		int* l, int* r )
+{
+	// regroup as l0 l1 r0 r1 l2 l3 r2 r3 so pmaddwd sums left and right separately
+	__m128i lo = _mm_packs_epi32( _mm_loadu_si128( (__m128i const*) hist [0] ),
+			_mm_loadu_si128( (__m128i const*) hist [2] ) );
+	__m128i hi = _mm_packs_epi32( _mm_loadu_si128( (__m128i const*) hist [4] ),
+			_mm_loadu_si128( (__m128i const*) hist [6] ) );
+	lo = _mm_shufflehi_epi16( _mm_shufflelo_epi16( lo, 0xD8 ), 0xD8 );
+	hi = _mm_shufflehi_epi16( _mm_shufflelo_epi16( hi, 0xD8 ), 0xD8 );
+
+	__m128i sum = _mm_add_epi32( _mm_madd_epi16( lo, fir_lo ), _mm_madd_epi16( hi, fir_hi ) );
+	sum = _mm_add_epi32( sum, _mm_srli_si128( sum, 8 ) );
+	*l = _mm_cvtsi128_si32( sum );
+	*r = _mm_cvtsi128_si32( _mm_srli_si128( sum, 4 ) );
+}
+
+#endif
+
+
 //// Emulation
 
 void Spc_Dsp::run( int clock_count )
@@ -196,6 +225,13 @@ void Spc_Dsp::run( int clock_count )
 	int const slow_gaussian = (REG(pmon) >> 1) | REG(non);
 	int const noise_rate = REG(flg) & 0x1F;
 
+#if SPC_DSP_SSE2
+	#define FIR_PAIR( i ) (int8_t) REG(fir + i * 0x10), (int8_t) REG(fir + (i + 1) * 0x10)
+	__m128i const fir_lo = _mm_setr_epi16( FIR_PAIR( 0 ), FIR_PAIR( 0 ), FIR_PAIR( 2 ), FIR_PAIR( 2 ) );
+	__m128i const fir_hi = _mm_setr_epi16( FIR_PAIR( 4 ), FIR_PAIR( 4 ), FIR_PAIR( 6 ), FIR_PAIR( 6 ) );
+	#undef FIR_PAIR
+#endif
+
 	// Global volume
 	int mvoll = (int8_t) REG(mvoll);
 	int mvolr = (int8_t) REG(mvolr);
@@ -567,6 +603,9 @@ skip_brr:
 		echo_hist_pos [0] [0] = echo_hist_pos [8] [0] = echo_in_l;
 		echo_hist_pos [0] [1] = echo_hist_pos [8] [1] = echo_in_r;
 
+	#if SPC_DSP_SSE2
+		echo_fir_sse2( echo_hist_pos + 1, fir_lo, fir_hi, &echo_in_l, &echo_in_r );
+	#else
 		#define CALC_FIR_( i, in )  ((in) * (int8_t) REG(fir + i * 0x10))
 		echo_in_l = CALC_FIR_( 7, echo_in_l );
 		echo_in_r = CALC_FIR_( 7, echo_in_r );
@@ -585,6 +624,7 @@ skip_brr:
 		DO_FIR( 4 );
 		DO_FIR( 5 );
 		DO_FIR( 6 );
+	#endif
 
 		// Echo out
 		if ( !(REG(flg) & 0x20) )
@@ -198,6 +198,15 @@ inline void Spc_Dsp::disable_surround( bool disable )
 	m.surround_threshold = disable ? 0 : -0x4000;
 }
 
+// Run the echo FIR with SSE2
+#ifndef SPC_DSP_SSE2
+	#if defined (__SSE2__)
+		#define SPC_DSP_SSE2 1
+	#else
+		#define SPC_DSP_SSE2 0
+	#endif
+#endif
+
 #define SPC_NO_COPY_STATE_FUNCS 1
 
 #define SPC_LESS_ACCURATE 1
@@ -331,6 +331,23 @@ blargg_err_t Spc_Emu::skip_( long count )
 	return play_( resampler_latency, buf );
 }
 
+bool Spc_Emu::copy_state_( byte** io, blargg_copy_func_t copy )
+{
+	copy( io, &apu, sizeof apu ); // includes RAM and DSP
+	return true;
+}
+
+long Spc_Emu::buffered_samples_() const
+{
+	return (sample_rate() != native_sample_rate) ? resampler.avail() : 0;
+}
+
+void Spc_Emu::state_loaded_()
+{
+	resampler.clear();
+	filter.clear();
+}
+
 blargg_err_t Spc_Emu::play_( long count, sample_t* out )
 {
 	if ( sample_rate() == native_sample_rate )
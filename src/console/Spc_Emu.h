@@ -64,6 +64,9 @@ protected:
 	blargg_err_t start_track_( int );
 	blargg_err_t play_( long, sample_t* );
 	blargg_err_t skip_( long );
+	bool copy_state_( byte**, blargg_copy_func_t );
+	long buffered_samples_() const;
+	void state_loaded_();
 	void mute_voices_( int );
 	void set_tempo_( double );
 	void enable_accuracy_( bool );
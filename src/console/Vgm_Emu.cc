@@ -406,6 +406,43 @@ blargg_err_t Vgm_Emu::run_clocks( blip_time_t& time_io, int msec )
 	return 0;
 }
 
+bool Vgm_Emu::copy_state_( byte** io, blargg_copy_func_t copy )
+{
+	copy( io, &pos, sizeof pos );
+	copy( io, &vgm_time, sizeof vgm_time );
+	copy( io, &pcm_pos, sizeof pcm_pos );
+	copy( io, &dac_amp, sizeof dac_amp );
+	copy( io, &dac_disabled, sizeof dac_disabled );
+	copy( io, &psg, sizeof psg ); // outputs are reattached by remute_voices()
+
+	if ( uses_fm )
+	{
+		copy( io, &fm_time_offset, sizeof fm_time_offset );
+
+		if ( ym2413.enabled() )
+			ym2413.copy_state( io, copy );
+
+		if ( ym2612.enabled() )
+			ym2612.copy_state( io, copy );
+	}
+	return true;
+}
+
+long Vgm_Emu::buffered_samples_() const
+{
+	return uses_fm ? Dual_Resampler::samples_avail() : Classic_Emu::buffered_samples_();
+}
+
+void Vgm_Emu::state_loaded_()
+{
+	Classic_Emu::state_loaded_();
+	if ( uses_fm )
+	{
+		blip_buf.clear();
+		Dual_Resampler::clear();
+	}
+}
+
 blargg_err_t Vgm_Emu::play_( long count, sample_t* out )
 {
 	if ( !uses_fm )
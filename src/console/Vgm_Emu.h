@@ -66,6 +66,9 @@ protected:
 	blargg_err_t start_track_( int );
 	blargg_err_t play_( long count, sample_t* );
 	blargg_err_t run_clocks( blip_time_t&, int );
+	bool copy_state_( byte**, blargg_copy_func_t );
+	long buffered_samples_() const;
+	void state_loaded_();
 	void set_tempo_( double );
 	void mute_voices_( int mask );
 	void set_voice( int, Blip_Buffer*, Blip_Buffer*, Blip_Buffer* );
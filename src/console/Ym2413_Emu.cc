@@ -2203,6 +2203,11 @@ void Ym2413_Emu::mute_voices( int mask )
 	OPLL_setMask( opll, mask );
 }
 
+void Ym2413_Emu::copy_state( unsigned char** io, blargg_copy_func_t copy )
+{
+	copy( io, opll, sizeof *opll );
+}
+
 void Ym2413_Emu::run( int pair_count, sample_t* out )
 {
 	while ( pair_count-- )
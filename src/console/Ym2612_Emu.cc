@@ -11,6 +11,10 @@
 #include <stdio.h>
 #include <math.h>
 
+#if YM2612_EMU_SSE2
+	#include <emmintrin.h>
+#endif
+
 /* Copyright (C) 2002 Stphane Dallongeville (gens AT consolemul.com) */
 /* Copyright (C) 2004-2006 Shay Green. This module is free software; you
 can redistribute it and/or modify it under the terms of the GNU Lesser
@@ -961,6 +965,13 @@ void Ym2612_Emu::write1( int addr, int data )
 
 void Ym2612_Emu::mute_voices( int mask ) { impl->mute_mask = mask; }
 
+void Ym2612_Emu::copy_state( unsigned char** io, blargg_copy_func_t copy )
+{
+	copy( io, &impl->YM2612, sizeof impl->YM2612 );
+	copy( io, &impl->g.LFOcnt, sizeof impl->g.LFOcnt );
+	copy( io, &impl->g.LFOinc, sizeof impl->g.LFOinc );
+}
+
 static void update_envelope_( slot_t* sl )
 {
 	switch ( sl->Ecurp )
@@ -1031,6 +1042,29 @@ inline void update_envelope( slot_t& sl )
 		update_envelope_( &sl );
 }
 
+#if YM2612_EMU_SSE2
+
+// The four slots of a channel as the lanes of a vector, in SLOT [] order
+
+#define SLOT_LANES( ch, field ) _mm_setr_epi32( ch.SLOT [0].field, ch.SLOT [1].field, \
+		ch.SLOT [2].field, ch.SLOT [3].field )
+
+union slot_lanes_t
+{
+	__m128i v;
+	int i [4];
+};
+
+// Low 32 bits of the products of 32-bit lanes
+static inline __m128i mullo_epi32( __m128i a, __m128i b )
+{
+	__m128i even = _mm_mul_epu32( a, b );
+	__m128i odd  = _mm_mul_epu32( _mm_srli_epi64( a, 32 ), _mm_srli_epi64( b, 32 ) );
+	return _mm_unpacklo_epi32( _mm_shuffle_epi32( even, 0x08 ), _mm_shuffle_epi32( odd, 0x08 ) );
+}
+
+#endif
+
 template<int algo>
 struct ym2612_update_chan {
 	static void func( tables_t&, channel_t&, Ym2612_Emu::sample_t*, int );
@@ -1059,10 +1093,36 @@ void ym2612_update_chan<algo>::func( tables_t& g, channel_t& ch,
 
 	int CH_S0_OUT_1 = ch.S0_OUT [1];
 
+#if YM2612_EMU_SSE2
+	// Phases and envelopes of all four slots are advanced together
+	__m128i const finc = SLOT_LANES( ch, Finc );
+	__m128i const tll  = SLOT_LANES( ch, TLL );
+	__m128i ecnt, einc, ecmp, env_xor, env_max;
+	#define LOAD_ENV_LANES() (\
+		ecnt    = SLOT_LANES( ch, Ecnt ),\
+		einc    = SLOT_LANES( ch, Einc ),\
+		ecmp    = SLOT_LANES( ch, Ecmp ),\
+		env_xor = SLOT_LANES( ch, env_xor ),\
+		env_max = SLOT_LANES( ch, env_max ))
+	LOAD_ENV_LANES();
+
+	int const ams0 = ch.SLOT [0].AMS;
+	int const ams1 = ch.SLOT [1].AMS;
+	int const ams2 = ch.SLOT [2].AMS;
+	int const ams3 = ch.SLOT [3].AMS;
+
+	slot_lanes_t in, en;
+	in.v = SLOT_LANES( ch, Fcnt );
+	#define in0 in.i [S0]
+	#define in1 in.i [S1]
+	#define in2 in.i [S2]
+	#define in3 in.i [S3]
+#else
 	int in0 = ch.SLOT [S0].Fcnt;
 	int in1 = ch.SLOT [S1].Fcnt;
 	int in2 = ch.SLOT [S2].Fcnt;
 	int in3 = ch.SLOT [S3].Fcnt;
+#endif
 
 	int YM2612_LFOinc = g.LFOinc;
 	int YM2612_LFOcnt = g.LFOcnt + YM2612_LFOinc;
@@ -1077,6 +1137,22 @@ void ym2612_update_chan<algo>::func( tables_t& g, channel_t& ch,
 
 		short const* const ENV_TAB = g.ENV_TAB;
 
+	#if YM2612_EMU_SSE2
+		{
+			// ENV_LBITS is 16, so the table indices are the odd 16-bit lanes
+			__m128i temp = _mm_add_epi32( tll, _mm_setr_epi32(
+					ENV_TAB [_mm_extract_epi16( ecnt, 1 )], ENV_TAB [_mm_extract_epi16( ecnt, 3 )],
+					ENV_TAB [_mm_extract_epi16( ecnt, 5 )], ENV_TAB [_mm_extract_epi16( ecnt, 7 )] ) );
+			__m128i lfo = _mm_setr_epi32( env_LFO >> ams0, env_LFO >> ams1,
+					env_LFO >> ams2, env_LFO >> ams3 );
+			en.v = _mm_and_si128( _mm_add_epi32( _mm_xor_si128( temp, env_xor ), lfo ),
+					_mm_cmplt_epi32( temp, env_max ) );
+		}
+		#define en0 en.i [S0]
+		#define en1 en.i [S1]
+		#define en2 en.i [S2]
+		#define en3 en.i [S3]
+	#else
 	#define CALC_EN( x ) \
 		int temp##x = ENV_TAB [ch.SLOT [S##x].Ecnt >> ENV_LBITS] + ch.SLOT [S##x].TLL;  \
 		int en##x = ((temp##x ^ ch.SLOT [S##x].env_xor) + (env_LFO >> ch.SLOT [S##x].AMS)) &    \
@@ -1086,6 +1162,7 @@ void ym2612_update_chan<algo>::func( tables_t& g, channel_t& ch,
 		CALC_EN( 1 )
 		CALC_EN( 2 )
 		CALC_EN( 3 )
+	#endif
 
 		int const* const TL_TAB = g.TL_TAB;
 
@@ -1162,18 +1239,41 @@ void ym2612_update_chan<algo>::func( tables_t& g, channel_t& ch,
 		unsigned freq_LFO = ((g.LFO_FREQ_TAB [YM2612_LFOcnt >> LFO_LBITS & LFO_MASK] *
 				ch.FMS) >> (LFO_HBITS - 1 + 1)) + (1L << (LFO_FMS_LBITS - 1));
 		YM2612_LFOcnt += YM2612_LFOinc;
+	#if YM2612_EMU_SSE2
+		in.v = _mm_add_epi32( in.v, _mm_srli_epi32( mullo_epi32( finc,
+				_mm_set1_epi32( freq_LFO ) ), LFO_FMS_LBITS - 1 ) );
+	#else
 		in0 += (ch.SLOT [S0].Finc * freq_LFO) >> (LFO_FMS_LBITS - 1);
 		in1 += (ch.SLOT [S1].Finc * freq_LFO) >> (LFO_FMS_LBITS - 1);
 		in2 += (ch.SLOT [S2].Finc * freq_LFO) >> (LFO_FMS_LBITS - 1);
 		in3 += (ch.SLOT [S3].Finc * freq_LFO) >> (LFO_FMS_LBITS - 1);
+	#endif
 
 		int t0 = buf [0] + (CH_OUTd & ch.LEFT);
 		int t1 = buf [1] + (CH_OUTd & ch.RIGHT);
 
+	#if YM2612_EMU_SSE2
+		ecnt = _mm_add_epi32( ecnt, einc );
+		int next = _mm_movemask_ps( _mm_castsi128_ps( _mm_cmplt_epi32( ecnt, ecmp ) ) ) ^ 0x0F;
+		if ( next )
+		{
+			// rare; let the scalar code move those slots to their next phase
+			slot_lanes_t e;
+			e.v = ecnt;
+			for ( int i = 0; i < 4; i++ )
+			{
+				ch.SLOT [i].Ecnt = e.i [i];
+				if ( next >> i & 1 )
+					update_envelope_( &ch.SLOT [i] );
+			}
+			LOAD_ENV_LANES();
+		}
+	#else
 		update_envelope( ch.SLOT [0] );
 		update_envelope( ch.SLOT [1] );
 		update_envelope( ch.SLOT [2] );
 		update_envelope( ch.SLOT [3] );
+	#endif
 
 		ch.S0_OUT [0] = CH_S0_OUT_0;
 		buf [0] = t0;
@@ -1184,10 +1284,31 @@ void ym2612_update_chan<algo>::func( tables_t& g, channel_t& ch,
 
 	ch.S0_OUT [1] = CH_S0_OUT_1;
 
+#if YM2612_EMU_SSE2
+	{
+		slot_lanes_t e;
+		e.v = ecnt;
+		for ( int i = 0; i < 4; i++ )
+			ch.SLOT [i].Ecnt = e.i [i];
+	}
+#endif
+
 	ch.SLOT [S0].Fcnt = in0;
 	ch.SLOT [S1].Fcnt = in1;
 	ch.SLOT [S2].Fcnt = in2;
 	ch.SLOT [S3].Fcnt = in3;
+
+#if YM2612_EMU_SSE2
+	#undef LOAD_ENV_LANES
+	#undef in0
+	#undef in1
+	#undef in2
+	#undef in3
+	#undef en0
+	#undef en1
+	#undef en2
+	#undef en3
+#endif
 }
 
 static const ym2612_update_chan_t UPDATE_CHAN [8] = {
@@ -4,6 +4,17 @@
 #ifndef YM2612_EMU_H
 #define YM2612_EMU_H
 
+#include "blargg_common.h"
+
+// Advance the four slots of a channel together with SSE2
+#ifndef YM2612_EMU_SSE2
+	#if defined (__SSE2__)
+		#define YM2612_EMU_SSE2 1
+	#else
+		#define YM2612_EMU_SSE2 0
+	#endif
+#endif
+
 struct Ym2612_Impl;
 
 class Ym2612_Emu  {
@@ -33,6 +44,9 @@ public:
 	typedef short sample_t;
 	enum { out_chan_count = 2 }; // stereo
 	void run( int pair_count, sample_t* out );
+
+	// Save/restore chip state (see blargg_common.h)
+	void copy_state( unsigned char** io, blargg_copy_func_t );
 };
 
 #endif
@@ -55,6 +55,11 @@ public:
 	}
 };
 
+// blargg_copy_func_t - saves or restores a block of emulator state at *io and
+// advances *io past it. Snapshots made this way are only restored into the same
+// object that saved them, so blocks may contain pointers to its own members.
+typedef void (*blargg_copy_func_t)( unsigned char** io, void* state, size_t size );
+
 // BLARGG_4CHAR('a','b','c','d') = 'abcd' (four character integer constant)
 #define BLARGG_4CHAR( a, b, c, d ) \
 	((a&0xFF)*0x1000000L + (b&0xFF)*0x10000L + (c&0xFF)*0x100L + (d&0xFF))
@@ -9,6 +9,7 @@
  */
 
 #include "configure.h"
+#include "length_cache.h"
 #include "plugin.h"
 
 #include <libaudcore/runtime.h>
@@ -26,6 +27,7 @@ const char * const ConsolePlugin::defaults[] = {
  "ignore_spc_length", "FALSE",
  "echo", "0",
  "inc_spc_reverb", "FALSE",
+ "detect_length", "FALSE",
  nullptr};
 
 bool ConsolePlugin::init ()
@@ -40,12 +42,15 @@ bool ConsolePlugin::init ()
     audcfg.ignore_spc_length = aud_get_bool (CON_CFGID, "ignore_spc_length");
     audcfg.echo = aud_get_int (CON_CFGID, "echo");
     audcfg.inc_spc_reverb = aud_get_bool (CON_CFGID, "inc_spc_reverb");
+    audcfg.detect_length = aud_get_bool (CON_CFGID, "detect_length");
 
     return true;
 }
 
 void ConsolePlugin::cleanup ()
 {
+    length_cache_stop ();
+
     aud_set_int (CON_CFGID, "loop_length", audcfg.loop_length);
     aud_set_bool (CON_CFGID, "resample", audcfg.resample);
     aud_set_int (CON_CFGID, "resample_rate", audcfg.resample_rate);
@@ -54,4 +59,5 @@ void ConsolePlugin::cleanup ()
     aud_set_bool (CON_CFGID, "ignore_spc_length", audcfg.ignore_spc_length);
     aud_set_int (CON_CFGID, "echo", audcfg.echo);
     aud_set_bool (CON_CFGID, "inc_spc_reverb", audcfg.inc_spc_reverb);
+    aud_set_bool (CON_CFGID, "detect_length", audcfg.detect_length);
 }
@@ -18,6 +18,7 @@ typedef struct {
 	bool ignore_spc_length; /* if true, ignore length from SPC tags */
 	int echo;                  /* 0 to +100 */
 	bool inc_spc_reverb;    /* if true, increases the default reverb */
+	bool detect_length;     /* if true, find lengths of untimed tracks in the background */
 } AudaciousConsoleConfig;
 
 extern AudaciousConsoleConfig audcfg;
@@ -0,0 +1,167 @@
+/*
+ * Audacious: Cross platform multimedia player
+ * Copyright (c) 2026 Audacious Team
+ *
+ * Driver for Game_Music_Emu library. See details at:
+ * http://www.slack.net/~ant/libs/
+ */
+
+#include <pthread.h>
+#include <string.h>
+
+#include <atomic>
+
+#include <glib.h>
+
+#include <libaudcore/audstrings.h>
+#include <libaudcore/mainloop.h>
+#include <libaudcore/multihash.h>
+#include <libaudcore/playlist.h>
+#include <libaudcore/runtime.h>
+
+#include "length_cache.h"
+#include "../plugin-common/disk-cache.h"
+
+#define MAX_THREADS 4
+
+/* at most 4 MB of lengths */
+static DiskCache cache ("console-lengths", "GMEL", 2, 4 << 20);
+
+static pthread_mutex_t s_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_cond = PTHREAD_COND_INITIALIZER;
+
+static pthread_t s_threads[MAX_THREADS];
+static int s_n_threads;
+static std::atomic<bool> s_quit;
+
+struct FinishedFile
+{
+    String path;
+    int n_tracks;
+};
+
+static Index<String> s_queue;           /* files waiting for a worker */
+static Index<FinishedFile> s_finished;  /* files whose entries need a rescan */
+static SimpleHash<String, bool> s_seen;  /* never queue a file twice */
+
+static QueuedFunc s_rescan;
+
+TrackLength length_cache_lookup (const char * path, int64_t size, int track)
+{
+    Index<char> data;
+    TrackLength length = {LENGTH_UNKNOWN, 0};
+
+    if (! cache.load (path, size, data) || track < 0 ||
+     track >= (int) (data.len () / sizeof length) || data.len () % sizeof length)
+        return length;
+
+    memcpy (& length, data.begin () + track * sizeof length, sizeof length);
+    return length;
+}
+
+static void save_lengths (const char * path, int64_t size, const Index<TrackLength> & lengths)
+{
+    Index<char> data;
+    disk_cache_append (data, lengths.begin (), lengths.len ());
+
+    cache.save (path, size, data);
+}
+
+/* runs in the main thread; reading the tags again picks up the new lengths */
+static void rescan_finished (void *)
+{
+    pthread_mutex_lock (& s_mutex);
+    Index<FinishedFile> finished = std::move (s_finished);
+    pthread_mutex_unlock (& s_mutex);
+
+    for (const FinishedFile & file : finished)
+    {
+        Playlist::rescan_file (file.path);
+
+        for (int i = 0; i < file.n_tracks; i ++)
+            Playlist::rescan_file (str_printf ("%s?%d", (const char *) file.path, i + 1));
+    }
+}
+
+static void * worker_thread (void *)
+{
+    pthread_mutex_lock (& s_mutex);
+
+    while (! s_quit)
+    {
+        if (! s_queue.len ())
+        {
+            pthread_cond_wait (& s_cond, & s_mutex);
+            continue;
+        }
+
+        String path = std::move (s_queue[0]);
+        s_queue.remove (0, 1);
+
+        pthread_mutex_unlock (& s_mutex);
+
+        int64_t size = -1;
+        Index<TrackLength> lengths;
+        bool done = console_detect_lengths (path, size, lengths, & s_quit);
+
+        if (done)
+            save_lengths (path, size, lengths);
+
+        pthread_mutex_lock (& s_mutex);
+
+        if (done && ! s_quit)
+        {
+            s_finished.append (FinishedFile {path, lengths.len ()});
+            s_rescan.queue (rescan_finished, nullptr);
+        }
+    }
+
+    pthread_mutex_unlock (& s_mutex);
+    return nullptr;
+}
+
+void length_cache_queue (const char * path)
+{
+    String key (path);
+
+    pthread_mutex_lock (& s_mutex);
+
+    if (! s_quit && ! s_seen.lookup (key))
+    {
+        s_seen.add (key, true);
+        s_queue.append (key);
+
+        /* the workers are started on first use and run until cleanup */
+        if (! s_n_threads)
+        {
+            int threads = aud::clamp ((int) g_get_num_processors () / 2, 1, MAX_THREADS);
+
+            while (s_n_threads < threads &&
+             ! pthread_create (& s_threads[s_n_threads], nullptr, worker_thread, nullptr))
+                s_n_threads ++;
+        }
+
+        pthread_cond_signal (& s_cond);
+    }
+
+    pthread_mutex_unlock (& s_mutex);
+}
+
+void length_cache_stop ()
+{
+    pthread_mutex_lock (& s_mutex);
+    s_quit = true;
+    pthread_cond_broadcast (& s_cond);
+    pthread_mutex_unlock (& s_mutex);
+
+    for (int i = 0; i < s_n_threads; i ++)
+        pthread_join (s_threads[i], nullptr);
+
+    s_rescan.stop ();
+
+    s_n_threads = 0;
+    s_queue.clear ();
+    s_finished.clear ();
+    s_seen.clear ();
+    s_quit = false;
+}
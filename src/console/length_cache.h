@@ -0,0 +1,43 @@
+/*
+ * Audacious: Cross platform multimedia player
+ * Copyright (c) 2026 Audacious Team
+ *
+ * Driver for Game_Music_Emu library. See details at:
+ * http://www.slack.net/~ant/libs/
+ */
+
+#ifndef AUD_CONSOLE_LENGTH_CACHE_H
+#define AUD_CONSOLE_LENGTH_CACHE_H 1
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include <libaudcore/index.h>
+
+/* Lengths of tracks that lack timing information, found by rendering them
+ * in the background until the silence detector ends them or the output
+ * starts repeating.  Results are kept in a cache file per music file,
+ * indexed by track number. */
+
+#define LENGTH_UNKNOWN 0   /* not analyzed yet */
+#define LENGTH_ENDLESS (-1) /* still playing after the analysis limit */
+
+struct TrackLength
+{
+    int32_t length;  /* milliseconds, LENGTH_UNKNOWN or LENGTH_ENDLESS */
+    int32_t loop;    /* if the track loops, the length of the loop; <length>
+                        is then the intro plus two passes through it */
+};
+
+/* length_cache.cc */
+TrackLength length_cache_lookup (const char * path, int64_t size, int track);
+void length_cache_queue (const char * path);
+void length_cache_stop ();
+
+/* Audacious_Driver.cc; fills in one entry per track and returns false if the
+ * file could not be loaded or <abort> was set */
+bool console_detect_lengths (const char * path, int64_t & size,
+ Index<TrackLength> & lengths, const std::atomic<bool> * abort);
+
+#endif /* AUD_CONSOLE_LENGTH_CACHE_H */
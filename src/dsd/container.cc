@@ -0,0 +1,441 @@
+/*
+ * DSD Input Plugin for Audacious
+ * Copyright (C) 2026 Audacious developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/* DSF (Sony) and DSDIFF (Philips) container parsing, plus just enough of
+ * ID3v2 to read the tags both formats carry. */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <libaudcore/audstrings.h>
+#include <libaudcore/runtime.h>
+
+#include "dsd.h"
+
+#define MAX_TAG_SIZE (16 * 1024 * 1024)
+
+/* fixed by the DSF specification */
+#define DSF_BLOCK_SIZE 4096
+
+static uint32_t get_le32 (const unsigned char * p)
+    { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24); }
+static uint64_t get_le64 (const unsigned char * p)
+    { return get_le32 (p) | ((uint64_t) get_le32 (p + 4) << 32); }
+static uint32_t get_be16 (const unsigned char * p)
+    { return (p[0] << 8) | p[1]; }
+static uint32_t get_be32 (const unsigned char * p)
+    { return ((uint32_t) p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3]; }
+static uint64_t get_be64 (const unsigned char * p)
+    { return ((uint64_t) get_be32 (p) << 32) | get_be32 (p + 4); }
+
+static bool valid_rate (int rate)
+{
+    return rate >= 44100 * 64 && (rate % (44100 * 64) == 0 || rate % (48000 * 64) == 0);
+}
+
+static bool read_dsf (VFSFile & file, DSDInfo & info)
+{
+    unsigned char head[28 + 52 + 12];
+
+    if (file.fread (head, 1, sizeof head) != sizeof head)
+        return false;
+
+    const unsigned char * dsd = head;
+    const unsigned char * fmt = head + 28;
+    const unsigned char * data = head + 80;
+
+    if (memcmp (dsd, "DSD ", 4) || get_le64 (dsd + 4) != 28 ||
+     memcmp (fmt, "fmt ", 4) || get_le64 (fmt + 4) != 52 ||
+     memcmp (data, "data", 4))
+        return false;
+
+    uint32_t format_id = get_le32 (fmt + 16);
+    uint32_t bits = get_le32 (fmt + 32);
+
+    if (format_id != 0 || (bits != 1 && bits != 8))
+    {
+        AUDERR ("Unsupported DSF format (id %u, %u bits).\n", format_id, bits);
+        return false;
+    }
+
+    info.container = DSDContainer::DSF;
+    info.channels = get_le32 (fmt + 24);
+    info.rate = get_le32 (fmt + 28);
+    info.lsb_first = (bits == 1);
+    info.samples = get_le64 (fmt + 36);
+    info.block_size = get_le32 (fmt + 44);
+    info.data_start = sizeof head;
+    info.data_size = get_le64 (data + 4) - 12;
+
+    int64_t total_size = get_le64 (dsd + 12);
+    int64_t metadata = get_le64 (dsd + 20);
+
+    if (metadata > 0 && metadata < total_size)
+    {
+        info.id3_offset = metadata;
+        info.id3_size = total_size - metadata;
+    }
+
+    if (info.block_size != DSF_BLOCK_SIZE)
+    {
+        AUDERR ("Unsupported DSF block size (%d bytes).\n", info.block_size);
+        return false;
+    }
+
+    return true;
+}
+
+static String read_diin_text (VFSFile & file, int64_t size)
+{
+    unsigned char count[4];
+
+    if (size < 4 || size > MAX_TAG_SIZE || file.fread (count, 1, 4) != 4)
+        return String ();
+
+    int len = aud::min ((int64_t) get_be32 (count), size - 4);
+    Index<char> text;
+    text.insert (0, len);
+
+    if (file.fread (text.begin (), 1, len) != len)
+        return String ();
+
+    return String (str_to_utf8 (text.begin (), len));
+}
+
+static bool read_dff (VFSFile & file, DSDInfo & info)
+{
+    unsigned char head[16];
+
+    if (file.fread (head, 1, 16) != 16 || memcmp (head, "FRM8", 4) ||
+     memcmp (head + 12, "DSD ", 4))
+        return false;
+
+    int64_t form_end = 12 + get_be64 (head + 4);
+
+    info.container = DSDContainer::DFF;
+    info.block_size = 1;
+    info.lsb_first = false;
+
+    bool have_data = false;
+    int64_t pos = 16;
+
+    while (pos + 12 <= form_end)
+    {
+        unsigned char chunk[12];
+
+        if (file.fseek (pos, VFS_SEEK_SET) || file.fread (chunk, 1, 12) != 12)
+            break;
+
+        int64_t size = get_be64 (chunk + 4);
+        int64_t next = pos + 12 + size + (size & 1);
+
+        if (! memcmp (chunk, "PROP", 4))
+        {
+            unsigned char type[4];
+
+            if (file.fread (type, 1, 4) != 4 || memcmp (type, "SND ", 4))
+                return false;
+
+            int64_t sub = pos + 16;
+
+            while (sub + 12 <= pos + 12 + size)
+            {
+                unsigned char hdr[16];
+
+                if (file.fseek (sub, VFS_SEEK_SET) || file.fread (hdr, 1, 16) != 16)
+                    return false;
+
+                int64_t sub_size = get_be64 (hdr + 4);
+                if (sub_size < 0)
+                    return false;
+
+                if (! memcmp (hdr, "FS  ", 4))
+                    info.rate = get_be32 (hdr + 12);
+                else if (! memcmp (hdr, "CHNL", 4))
+                    info.channels = get_be16 (hdr + 12);
+                else if (! memcmp (hdr, "CMPR", 4) && memcmp (hdr + 12, "DSD ", 4))
+                {
+                    AUDERR ("Compressed (DST) DSDIFF files are not supported.\n");
+                    return false;
+                }
+
+                sub += 12 + sub_size + (sub_size & 1);
+            }
+        }
+        else if (! memcmp (chunk, "DSD ", 4))
+        {
+            info.data_start = pos + 12;
+            info.data_size = size;
+            have_data = true;
+        }
+        else if (! memcmp (chunk, "DST ", 4))
+        {
+            AUDERR ("Compressed (DST) DSDIFF files are not supported.\n");
+            return false;
+        }
+        else if (! memcmp (chunk, "DIIN", 4))
+        {
+            int64_t sub = pos + 12;
+
+            while (sub + 12 <= pos + 12 + size)
+            {
+                unsigned char hdr[12];
+
+                if (file.fseek (sub, VFS_SEEK_SET) || file.fread (hdr, 1, 12) != 12)
+                    break;
+
+                int64_t sub_size = get_be64 (hdr + 4);
+                if (sub_size < 0)
+                    break;
+
+                if (! memcmp (hdr, "DITI", 4))
+                    info.title = read_diin_text (file, sub_size);
+                else if (! memcmp (hdr, "DIAR", 4))
+                    info.artist = read_diin_text (file, sub_size);
+
+                sub += 12 + sub_size + (sub_size & 1);
+            }
+        }
+        else if (! memcmp (chunk, "ID3 ", 4))
+        {
+            info.id3_offset = pos + 12;
+            info.id3_size = size;
+        }
+
+        if (size < 0 || next <= pos)
+            break;
+
+        pos = next;
+    }
+
+    if (! have_data || info.channels <= 0)
+        return false;
+
+    info.samples = info.data_size / info.channels * 8;
+    return true;
+}
+
+bool dsd_read_header (VFSFile & file, DSDInfo & info)
+{
+    char magic[4];
+
+    info = DSDInfo ();
+
+    if (file.fread (magic, 1, 4) != 4 || file.fseek (0, VFS_SEEK_SET))
+        return false;
+
+    bool ok = false;
+
+    if (! memcmp (magic, "DSD ", 4))
+        ok = read_dsf (file, info);
+    else if (! memcmp (magic, "FRM8", 4))
+        ok = read_dff (file, info);
+
+    if (! ok)
+        return false;
+
+    if (info.channels < 1 || info.channels > DSD_MAX_CHANNELS || ! valid_rate (info.rate))
+    {
+        AUDERR ("Unsupported DSD stream (%d channels at %d Hz).\n", info.channels, info.rate);
+        return false;
+    }
+
+    return info.data_size > 0 && info.samples > 0;
+}
+
+static int syncsafe32 (const unsigned char * p)
+{
+    return (p[0] << 21) | (p[1] << 14) | (p[2] << 7) | p[3];
+}
+
+static StringBuf decode_text (int encoding, const char * text, int len)
+{
+    switch (encoding)
+    {
+    case 0:
+        return str_convert (text, len, "ISO-8859-1", "UTF-8");
+    case 1:
+        return str_convert (text, len, "UTF-16", "UTF-8");
+    case 2:
+        return str_convert (text, len, "UTF-16BE", "UTF-8");
+    default:
+        return str_copy (text, len);
+    }
+}
+
+/* length of a string terminated by one or two NUL bytes (depending on the
+ * encoding), or -1 if it is not terminated */
+static int text_length (int encoding, const char * text, int len)
+{
+    if (encoding == 1 || encoding == 2)
+    {
+        for (int i = 0; i + 1 < len; i += 2)
+        {
+            if (! text[i] && ! text[i + 1])
+                return i;
+        }
+
+        return -1;
+    }
+
+    const char * end = (const char *) memchr (text, 0, len);
+    return end ? end - text : -1;
+}
+
+static void read_text_frame (Tuple & tuple, const char * id, const char * data, int len)
+{
+    static const struct {
+        const char * id;
+        Tuple::Field field;
+    } text_fields[] = {
+        {"TIT2", Tuple::Title},
+        {"TPE1", Tuple::Artist},
+        {"TPE2", Tuple::AlbumArtist},
+        {"TALB", Tuple::Album},
+        {"TCON", Tuple::Genre},
+        {"TRCK", Tuple::Track},
+        {"TYER", Tuple::Year},
+        {"TDRC", Tuple::Year}
+    };
+
+    if (len < 2)
+        return;
+
+    for (auto & f : text_fields)
+    {
+        if (memcmp (id, f.id, 4))
+            continue;
+
+        int text_len = text_length (data[0], data + 1, len - 1);
+        StringBuf text = decode_text (data[0], data + 1, (text_len < 0) ? len - 1 : text_len);
+
+        if (! text || ! text[0])
+            return;
+
+        if (f.field == Tuple::Track || f.field == Tuple::Year)
+            tuple.set_int (f.field, atoi (text));
+        else
+            tuple.set_str (f.field, text);
+
+        return;
+    }
+}
+
+static void read_picture_frame (Index<char> * image, const char * data, int len)
+{
+    if (len < 4 || image->len ())
+        return;
+
+    int encoding = data[0];
+    const char * p = data + 1;
+    const char * end = data + len;
+
+    /* MIME type, then picture type, then description */
+    int mime_len = text_length (0, p, end - p);
+    if (mime_len < 0)
+        return;
+
+    p += mime_len + 1;
+    if (end - p < 1)
+        return;
+
+    p ++;
+
+    int desc_len = text_length (encoding, p, end - p);
+    if (desc_len < 0)
+        return;
+
+    p += desc_len + ((encoding == 1 || encoding == 2) ? 2 : 1);
+
+    if (p < end)
+        image->insert (p, 0, end - p);
+}
+
+static void read_id3v2 (const unsigned char * tag, int size, Tuple & tuple, Index<char> * image)
+{
+    if (size < 10 || memcmp (tag, "ID3", 3) || (tag[3] != 3 && tag[3] != 4))
+        return;
+
+    int version = tag[3];
+    int flags = tag[5];
+    int end = aud::min (10 + syncsafe32 (tag + 6), size);
+    int pos = 10;
+
+    /* unsynchronized tags are rare enough to not be worth the trouble */
+    if (flags & 0x80)
+        return;
+
+    /* the v2.3 size leaves out the size field itself */
+    if ((flags & 0x40) && pos + 4 <= end)
+    {
+        uint64_t ext_size = (version == 3) ? 4 + (uint64_t) get_be32 (tag + pos) : syncsafe32 (tag + pos);
+
+        if (ext_size > (uint64_t) (end - pos))
+            return;
+
+        pos += (int) ext_size;
+    }
+
+    while (pos + 10 <= end && tag[pos])
+    {
+        const char * id = (const char *) tag + pos;
+        int frame_size = (version == 3) ? (int) get_be32 (tag + pos + 4) : syncsafe32 (tag + pos + 4);
+        int frame_flags = get_be16 (tag + pos + 8);
+
+        pos += 10;
+
+        if (frame_size < 0 || frame_size > end - pos)
+            break;
+
+        /* skip compressed or encrypted frames */
+        bool plain = (version == 3) ? ! (frame_flags & 0xc0) : ! (frame_flags & 0x0f);
+
+        if (plain)
+        {
+            const char * data = (const char *) tag + pos;
+
+            if (id[0] == 'T')
+                read_text_frame (tuple, id, data, frame_size);
+            else if (image && ! memcmp (id, "APIC", 4))
+                read_picture_frame (image, data, frame_size);
+        }
+
+        pos += frame_size;
+    }
+}
+
+void dsd_read_tags (VFSFile & file, const DSDInfo & info, Tuple & tuple, Index<char> * image)
+{
+    if (info.title)
+        tuple.set_str (Tuple::Title, info.title);
+    if (info.artist)
+        tuple.set_str (Tuple::Artist, info.artist);
+
+    if (! info.id3_offset || info.id3_size < 10 || info.id3_size > MAX_TAG_SIZE)
+        return;
+
+    Index<unsigned char> tag;
+    tag.insert (0, info.id3_size);
+
+    if (file.fseek (info.id3_offset, VFS_SEEK_SET) ||
+     file.fread (tag.begin (), 1, tag.len ()) != tag.len ())
+        return;
+
+    read_id3v2 (tag.begin (), tag.len (), tuple, image);
+}
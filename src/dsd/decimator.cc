@@ -0,0 +1,219 @@
+/*
+ * DSD Input Plugin for Audacious
+ * Copyright (C) 2026 Audacious developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <math.h>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#include "dsd.h"
+
+/* first stage: 128 taps, looked up 8 at a time */
+#define TABLE_BYTES 16
+#define TABLE_TAPS (TABLE_BYTES * 8)
+
+/* DSD "digital silence" pattern, used to prime the first stage */
+#define DSD_SILENCE 0x69
+
+/* highest frequency kept clean of aliases, as a fraction of the PCM rate */
+#define PASSBAND 0.35
+
+/* windowed-sinc lowpass, <fc> in cycles per sample, unity gain at DC,
+ * padded with zeros to a multiple of 4 taps */
+static Index<float> design_lowpass (int taps, double fc)
+{
+    Index<float> coeffs;
+    coeffs.insert (0, (taps + 3) & ~3);
+
+    double center = (taps - 1) / 2.0;
+    double sum = 0;
+
+    for (int i = 0; i < taps; i ++)
+    {
+        double x = i - center;
+        double sinc = x ? sin (2 * M_PI * fc * x) / (M_PI * x) : 2 * fc;
+        double window = 0.42 - 0.5 * cos (2 * M_PI * i / (taps - 1)) +
+         0.08 * cos (4 * M_PI * i / (taps - 1));
+
+        coeffs[i] = sinc * window;
+        sum += coeffs[i];
+    }
+
+    for (int i = 0; i < taps; i ++)
+        coeffs[i] /= sum;
+
+    return coeffs;
+}
+
+/* For each group of 8 taps, the sum of those taps weighted by +1 or -1
+ * according to the bits of every possible input byte. */
+struct FirTable
+{
+    float table[TABLE_BYTES][256];
+
+    FirTable ()
+    {
+        Index<float> h = design_lowpass (TABLE_TAPS, 1.0 / 32);
+
+        for (int k = 0; k < TABLE_BYTES; k ++)
+        {
+            for (int byte = 0; byte < 256; byte ++)
+            {
+                float sum = 0;
+
+                /* bit 7 is the earliest sample in the byte */
+                for (int bit = 0; bit < 8; bit ++)
+                {
+                    float tap = h[k * 8 + bit];
+                    sum += ((byte >> bit) & 1) ? tap : -tap;
+                }
+
+                table[k][byte] = sum;
+            }
+        }
+    }
+};
+
+static const FirTable & fir_table ()
+{
+    static const FirTable table;
+    return table;
+}
+
+static inline float dot (const float * a, const float * b, int len)
+{
+#ifdef __SSE__
+    __m128 acc = _mm_setzero_ps ();
+
+    for (int i = 0; i < len; i += 4)
+        acc = _mm_add_ps (acc, _mm_mul_ps (_mm_loadu_ps (a + i), _mm_loadu_ps (b + i)));
+
+    float sums[4];
+    _mm_storeu_ps (sums, acc);
+    return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+#else
+    float sum = 0;
+
+    for (int i = 0; i < len; i ++)
+        sum += a[i] * b[i];
+
+    return sum;
+#endif
+}
+
+int DSDDecimator::pcm_rate (int dsd_rate, bool high_rate)
+{
+    int base;
+
+    if (dsd_rate % 44100 == 0)
+        base = 44100;
+    else if (dsd_rate % 48000 == 0)
+        base = 48000;
+    else
+        return 0;
+
+    return base * (high_rate ? 4 : 2);
+}
+
+bool DSDDecimator::init (int dsd_rate, int pcm_rate)
+{
+    if (pcm_rate <= 0 || dsd_rate % pcm_rate)
+        return false;
+
+    int factor = dsd_rate / pcm_rate;
+
+    /* 8 in the first stage, then 2 per float stage */
+    if (factor < 16 || (factor & (factor - 1)) || factor > (8 << MaxStages))
+        return false;
+
+    m_n_stages = 0;
+    int rate = dsd_rate / 8;
+
+    for (; rate > pcm_rate; rate /= 2)
+    {
+        /* alias-free up to PASSBAND, cutoff in the middle of the transition */
+        double width = 0.5 - 2 * PASSBAND * pcm_rate / rate;
+        int taps = aud::max ((int) ceil (5.5 / width), 16);
+
+        Stage & stage = m_stages[m_n_stages ++];
+        stage.coeffs = design_lowpass (taps, 0.25);
+    }
+
+    fir_table ();
+    reset ();
+    return true;
+}
+
+void DSDDecimator::reset ()
+{
+    m_bytes.clear ();
+    m_bytes.insert (0, TABLE_BYTES - 1);
+
+    for (unsigned char & byte : m_bytes)
+        byte = DSD_SILENCE;
+
+    for (int s = 0; s < m_n_stages; s ++)
+    {
+        Stage & stage = m_stages[s];
+        stage.buf.clear ();
+        stage.buf.insert (0, stage.coeffs.len () - 1);
+    }
+}
+
+void DSDDecimator::process (const unsigned char * data, int len, Index<float> & out)
+{
+    const FirTable & fir = fir_table ();
+
+    m_bytes.insert (data, -1, len);
+
+    int count = m_bytes.len () - (TABLE_BYTES - 1);
+    m_temp.resize (count);
+
+    for (int i = 0; i < count; i ++)
+    {
+        const unsigned char * p = & m_bytes[i + TABLE_BYTES - 1];
+        float sum = 0;
+
+        for (int k = 0; k < TABLE_BYTES; k ++)
+            sum += fir.table[k][p[-k]];
+
+        m_temp[i] = sum;
+    }
+
+    m_bytes.remove (0, count);
+
+    for (int s = 0; s < m_n_stages; s ++)
+    {
+        Stage & stage = m_stages[s];
+        int taps = stage.coeffs.len ();
+
+        stage.buf.insert (m_temp.begin (), -1, m_temp.len ());
+
+        count = (stage.buf.len () >= taps) ? (stage.buf.len () - taps) / 2 + 1 : 0;
+        m_temp.resize (count);
+
+        for (int i = 0; i < count; i ++)
+            m_temp[i] = dot (stage.coeffs.begin (), & stage.buf[2 * i], taps);
+
+        stage.buf.remove (0, 2 * count);
+    }
+
+    out.insert (m_temp.begin (), -1, m_temp.len ());
+}
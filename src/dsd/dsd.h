@@ -0,0 +1,83 @@
+/*
+ * DSD Input Plugin for Audacious
+ * Copyright (C) 2026 Audacious developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef DSD_H
+#define DSD_H
+
+#include <stdint.h>
+
+#include <libaudcore/index.h>
+#include <libaudcore/objects.h>
+#include <libaudcore/tuple.h>
+#include <libaudcore/vfs.h>
+
+#define DSD_MAX_CHANNELS 6
+
+enum class DSDContainer {
+    DSF,
+    DFF
+};
+
+struct DSDInfo
+{
+    DSDContainer container;
+    int rate;             /* one-bit samples per second per channel */
+    int channels;
+    int64_t samples;      /* per channel */
+    int64_t data_start;
+    int64_t data_size;
+    int block_size;       /* bytes per channel per interleaving block */
+    bool lsb_first;
+    int64_t id3_offset;   /* 0 if there is no ID3v2 tag */
+    int64_t id3_size;
+    String title, artist; /* DSDIFF DIIN chunk */
+};
+
+/* container.cc */
+bool dsd_read_header (VFSFile & file, DSDInfo & info);
+void dsd_read_tags (VFSFile & file, const DSDInfo & info, Tuple & tuple, Index<char> * image);
+
+/* Converts one channel of one-bit DSD (MSB first) to PCM at rate / 2^n.
+ * The first stage decimates by 8 with a FIR whose taps are summed eight at
+ * a time from per-byte lookup tables; the remaining stages are float FIRs
+ * decimating by 2 each. */
+class DSDDecimator
+{
+public:
+    static int pcm_rate (int dsd_rate, bool high_rate);
+
+    bool init (int dsd_rate, int pcm_rate);
+    void reset ();
+    void process (const unsigned char * data, int len, Index<float> & out);
+
+private:
+    struct Stage {
+        Index<float> coeffs;
+        Index<float> buf;
+    };
+
+    static constexpr int MaxStages = 6;
+
+    Index<unsigned char> m_bytes;
+    Index<float> m_temp;
+    Stage m_stages[MaxStages];
+    int m_n_stages = 0;
+};
+
+#endif
@@ -0,0 +1,265 @@
+/*
+ * DSD Input Plugin for Audacious
+ * Copyright (C) 2026 Audacious developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <limits.h>
+#include <string.h>
+
+#include <libaudcore/audstrings.h>
+#include <libaudcore/i18n.h>
+#include <libaudcore/plugin.h>
+#include <libaudcore/preferences.h>
+#include <libaudcore/runtime.h>
+
+#include "dsd.h"
+
+/* bytes per channel read at once from DSDIFF files */
+#define DFF_CHUNK 4096
+
+class DSDPlugin : public InputPlugin
+{
+public:
+    static const char about[];
+    static const char * const exts[];
+    static const char * const mimes[];
+    static const char * const defaults[];
+    static const PreferencesWidget widgets[];
+    static const PluginPreferences prefs;
+
+    static constexpr PluginInfo info = {
+        N_("DSD Decoder"),
+        PACKAGE,
+        about,
+        & prefs
+    };
+
+    constexpr DSDPlugin () : InputPlugin (info, InputInfo ()
+        .with_exts (exts)
+        .with_mimes (mimes)) {}
+
+    bool init ();
+    bool is_our_file (const char * filename, VFSFile & file);
+    bool read_tag (const char * filename, VFSFile & file, Tuple & tuple, Index<char> * image);
+    bool play (const char * filename, VFSFile & file);
+};
+
+EXPORT DSDPlugin aud_plugin_instance;
+
+const char * const DSDPlugin::defaults[] = {
+    "high_rate", "FALSE",
+    nullptr
+};
+
+const PreferencesWidget DSDPlugin::widgets[] = {
+    WidgetLabel (N_("<b>Conversion</b>")),
+    WidgetCheck (N_("Convert to 176.4/192 kHz instead of 88.2/96 kHz"),
+        WidgetBool ("dsd", "high_rate"))
+};
+
+const PluginPreferences DSDPlugin::prefs = {{widgets}};
+
+bool DSDPlugin::init ()
+{
+    aud_config_set_defaults ("dsd", defaults);
+    return true;
+}
+
+bool DSDPlugin::is_our_file (const char * filename, VFSFile & file)
+{
+    unsigned char head[16];
+
+    if (file.fread (head, 1, 16) != 16)
+        return false;
+
+    return (! memcmp (head, "DSD ", 4) && head[4] == 28) ||
+     (! memcmp (head, "FRM8", 4) && ! memcmp (head + 12, "DSD ", 4));
+}
+
+static int dsd_multiple (int rate)
+{
+    return rate / ((rate % 44100) ? 48000 : 44100);
+}
+
+bool DSDPlugin::read_tag (const char * filename, VFSFile & file, Tuple & tuple,
+ Index<char> * image)
+{
+    DSDInfo info;
+
+    if (! dsd_read_header (file, info))
+        return false;
+
+    int rate = DSDDecimator::pcm_rate (info.rate, aud_get_bool ("dsd", "high_rate"));
+    const char * container = (info.container == DSDContainer::DSF) ? "DSF" : "DSDIFF";
+
+    tuple.set_format (str_printf ("%s (DSD%d)", container, dsd_multiple (info.rate)),
+     info.channels, rate, info.rate / 1000 * info.channels);
+    tuple.set_int (Tuple::Length, info.samples * 1000 / info.rate);
+
+    dsd_read_tags (file, info, tuple, image);
+    return true;
+}
+
+static const unsigned char * bit_reverse_table ()
+{
+    static const struct Table {
+        unsigned char t[256];
+
+        Table ()
+        {
+            for (int i = 0; i < 256; i ++)
+            {
+                int r = 0;
+                for (int bit = 0; bit < 8; bit ++)
+                    r |= ((i >> bit) & 1) << (7 - bit);
+
+                t[i] = r;
+            }
+        }
+    } table;
+
+    return table.t;
+}
+
+bool DSDPlugin::play (const char * filename, VFSFile & file)
+{
+    DSDInfo info;
+
+    if (! dsd_read_header (file, info))
+        return false;
+
+    int rate = DSDDecimator::pcm_rate (info.rate, aud_get_bool ("dsd", "high_rate"));
+    int channels = info.channels;
+    DSDDecimator decimators[DSD_MAX_CHANNELS];
+
+    for (int c = 0; c < channels; c ++)
+    {
+        if (! decimators[c].init (info.rate, rate))
+        {
+            AUDERR ("Cannot convert %d Hz DSD to %d Hz.\n", info.rate, rate);
+            return false;
+        }
+    }
+
+    /* DSF stores blocks of <block_size> bytes per channel; DSDIFF
+     * interleaves single bytes */
+    bool planar = (info.container == DSDContainer::DSF);
+    int per_channel = planar ? info.block_size : DFF_CHUNK;
+    int factor = info.rate / rate;
+
+    Index<unsigned char> raw, deinterleaved;
+    Index<float> pcm[DSD_MAX_CHANNELS];
+    Index<float> out;
+
+    raw.insert (0, per_channel * channels);
+    deinterleaved.insert (0, per_channel * channels);
+
+    const unsigned char * reverse = bit_reverse_table ();
+    int64_t total_bytes = (info.samples + 7) / 8;
+    int64_t pos = 0;   /* bytes per channel */
+    int64_t skip = 0;  /* output frames to drop after a seek */
+
+    if (file.fseek (info.data_start, VFS_SEEK_SET))
+        return false;
+
+    set_stream_bitrate (aud::min ((int64_t) info.rate * channels, (int64_t) INT_MAX));
+    open_audio (FMT_FLOAT, rate, channels);
+
+    while (! check_stop ())
+    {
+        int seek_value = check_seek ();
+
+        if (seek_value >= 0)
+        {
+            int64_t target = aud::min ((int64_t) seek_value * (info.rate / 8) / 1000, total_bytes);
+            int64_t aligned = target - target % info.block_size;
+
+            if (file.fseek (info.data_start + aligned * channels, VFS_SEEK_SET))
+            {
+                AUDERR ("Seek failed in %s.\n", filename);
+                return false;
+            }
+
+            for (int c = 0; c < channels; c ++)
+                decimators[c].reset ();
+
+            pos = aligned;
+            skip = (target - aligned) * 8 / factor;
+        }
+
+        if (pos >= total_bytes)
+            break;
+
+        int64_t len = file.fread (raw.begin (), 1, raw.len ());
+        int64_t got = len / channels;
+        int valid = aud::min (got, total_bytes - pos);
+
+        /* a DSF file always ends with a complete block */
+        if (valid <= 0 || (planar && got < per_channel))
+            break;
+
+        for (int c = 0; c < channels; c ++)
+        {
+            unsigned char * dest = & deinterleaved[c * per_channel];
+
+            if (planar)
+                memcpy (dest, & raw[c * per_channel], valid);
+            else
+            {
+                for (int i = 0; i < valid; i ++)
+                    dest[i] = raw[i * channels + c];
+            }
+
+            if (info.lsb_first)
+            {
+                for (int i = 0; i < valid; i ++)
+                    dest[i] = reverse[dest[i]];
+            }
+
+            pcm[c].clear ();
+            decimators[c].process (dest, valid, pcm[c]);
+        }
+
+        pos += got;
+
+        int frames = pcm[0].len ();
+        int start = aud::min ((int64_t) frames, skip);
+
+        skip -= start;
+        out.resize ((frames - start) * channels);
+
+        for (int f = start; f < frames; f ++)
+        {
+            for (int c = 0; c < channels; c ++)
+                out[(f - start) * channels + c] = pcm[c][f];
+        }
+
+        if (out.len ())
+            write_audio (out.begin (), out.len () * sizeof (float));
+    }
+
+    return true;
+}
+
+const char DSDPlugin::about[] =
+ N_("DSD Decoder for Audacious\n"
+    "Copyright (C) 2026 Audacious developers\n\n"
+    "Plays DSF and uncompressed DSDIFF files (DSD64 to DSD512), "
+    "converting them to floating-point PCM.");
+
+const char * const DSDPlugin::exts[] = {"dsf", "dff", nullptr};
+const char * const DSDPlugin::mimes[] = {"audio/x-dsf", "audio/x-dff", nullptr};
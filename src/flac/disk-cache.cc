@@ -0,0 +1 @@
+#include "../plugin-common/disk-cache.cc"
@@ -24,6 +24,32 @@
 
 #include <libaudcore/i18n.h>
 #include <libaudcore/plugin.h>
+#include <libaudcore/preferences.h>
+
+struct callback_info;
+
+struct SeekPoint
+{
+    int64_t sample, offset;
+};
+
+class SeekTable
+{
+public:
+    void load(const char *filename, const callback_info *info, int64_t file_size);
+    void save(const char *filename, const callback_info *info, int64_t file_size);
+
+    int find(int64_t sample) const;
+    const SeekPoint &point(int pos) const
+        { return m_points[pos]; }
+
+    void add(int64_t sample, int64_t offset);
+
+private:
+    Index<SeekPoint> m_points;
+    int64_t m_interval = 0;
+    bool m_dirty = false;
+};
 
 class FLACng : public InputPlugin
 {
@@ -31,11 +57,15 @@ public:
     static const char about[];
     static const char *const exts[];
     static const char *const mimes[];
+    static const char *const defaults[];
+    static const PreferencesWidget widgets[];
+    static const PluginPreferences prefs;
 
     static constexpr PluginInfo info = {
         N_("FLAC Decoder"),
         PACKAGE,
-        about
+        about,
+        &prefs
     };
 
     constexpr FLACng() : InputPlugin(info, InputInfo(FlagWritesTag)
@@ -50,6 +80,9 @@ public:
     bool read_tag(const char *filename, VFSFile &file, Tuple &tuple, Index<char> *image);
     bool write_tuple(const char *filename, VFSFile &file, const Tuple &tuple);
     bool play(const char *filename, VFSFile &file);
+
+private:
+    bool play_parallel(VFSFile &file, FLAC__StreamDecoder *decoder, callback_info *info, int threads);
 };
 
 #define BUFFER_SIZE_SAMP (FLAC__MAX_BLOCK_SIZE * FLAC__MAX_CHANNELS)
@@ -69,6 +102,10 @@ struct callback_info
     unsigned buffer_used = 0;
     VFSFile *fd = nullptr;
     int bitrate = 0;
+    FLAC__byte md5sum[16] = {};
+    bool has_seektable = false;
+    int64_t frame_sample = 0;
+    SeekTable *seek_table = nullptr;
 
     void alloc()
     {
@@ -101,4 +138,13 @@ void metadata_callback(const FLAC__StreamDecoder *decoder, const FLAC__StreamMet
 /* tools.c */
 bool read_metadata(FLAC__StreamDecoder* decoder, callback_info* info);
 
+/* plugin.c */
+void squeeze_audio(int32_t* src, void* dst, unsigned count, unsigned res);
+
+/* seektable.c */
+bool flac_seek(FLAC__StreamDecoder *decoder, callback_info *info, int64_t sample);
+
+/* parallel.c */
+int flac_parallel_threads(VFSFile &file, const callback_info *info);
+
 #endif
@@ -0,0 +1,606 @@
+/*
+ *  A FLAC decoder plugin for the Audacious Media Player
+ *  Copyright (C) 2026 Audacious developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Frame-parallel decoding.  FLAC frames do not depend on each other, so the
+ * main thread reads ahead, cuts the stream at frame boundaries (sync code
+ * plus a valid header CRC-8) and hands each range of frames to a pool of
+ * worker threads.  Every worker owns a private decoder which is fed a fake
+ * stream consisting of the original STREAMINFO block followed by the frames
+ * of one job.  The decoded jobs are written out strictly in order.
+ */
+
+#include <pthread.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <libaudcore/runtime.h>
+
+#include "flacng.h"
+
+/* compressed bytes per job */
+#define JOB_SIZE (512 * 1024)
+/* give up looking for a frame boundary after this much data */
+#define MAX_CARRY (8 * JOB_SIZE)
+
+/* "fLaC" + metadata block header + STREAMINFO */
+#define STREAM_HEADER_SIZE (4 + 4 + 34)
+
+#define MAX_THREADS 16
+
+/* only worth it for large hi-res or multichannel files */
+#define MIN_FILE_SIZE (16 * 1024 * 1024)
+#define MIN_SAMPLE_BITS (96000 * 2 * 24)
+
+struct ParallelJob
+{
+    Index<char> input;
+    Index<char> output;
+    bool done = false;
+};
+
+struct ParallelWorker
+{
+    pthread_t thread;
+    FLAC__StreamDecoder * decoder = nullptr;
+    class ParallelPool * pool = nullptr;
+
+    ParallelJob * job = nullptr;
+    int read_pos = 0;
+    Index<int32_t> frame_buffer;
+};
+
+class ParallelPool
+{
+public:
+    ParallelPool (unsigned bits_per_sample, unsigned channels) :
+        m_bits_per_sample (bits_per_sample),
+        m_channels (channels) {}
+
+    ~ParallelPool ()
+    {
+        stop ();
+        pthread_mutex_destroy (& m_mutex);
+        pthread_cond_destroy (& m_work_cond);
+        pthread_cond_destroy (& m_done_cond);
+    }
+
+    bool start (int threads);
+    void stop ();
+
+    void submit (ParallelJob * job);
+    int pending ();
+    ParallelJob * wait_front ();
+    void pop_front ();
+    void flush ();
+
+    const unsigned m_bits_per_sample, m_channels;
+
+private:
+    static void * worker_thread (void * data);
+
+    pthread_mutex_t m_mutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t m_work_cond = PTHREAD_COND_INITIALIZER;
+    pthread_cond_t m_done_cond = PTHREAD_COND_INITIALIZER;
+
+    Index<ParallelWorker> m_workers;
+    int m_running = 0;
+
+    Index<ParallelJob *> m_queue;
+    int m_dispatched = 0;
+    bool m_quit = false;
+};
+
+static unsigned crc8 (const unsigned char * data, int len)
+{
+    unsigned crc = 0;
+
+    for (int i = 0; i < len; i ++)
+    {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit ++)
+            crc = (crc & 0x80) ? ((crc << 1) ^ 0x07) & 0xff : (crc << 1) & 0xff;
+    }
+
+    return crc;
+}
+
+/* Checks for a frame header at <data>, matching the stream's channel count
+ * and sample size.  Returns the number of the first sample in the frame, or
+ * -1, and the number of samples in the frame in <block_size>. */
+static int64_t check_frame_header (const unsigned char * data, int avail,
+ const callback_info * info, unsigned & block_size)
+{
+    /* longest possible header is 16 bytes */
+    if (avail < 16)
+        return -1;
+
+    if (data[0] != 0xff || (data[1] & 0xfe) != 0xf8)
+        return -1;
+
+    unsigned block_code = data[2] >> 4;
+    unsigned rate_code = data[2] & 0xf;
+    unsigned chan_code = data[3] >> 4;
+    unsigned size_code = (data[3] >> 1) & 7;
+
+    if (! block_code || rate_code == 15 || chan_code > 10 || size_code == 3 ||
+     (data[3] & 1))
+        return -1;
+
+    unsigned channels = (chan_code < 8) ? chan_code + 1 : 2;
+    if (channels != info->channels)
+        return -1;
+
+    static const unsigned sample_sizes[8] = {0, 8, 12, 0, 16, 20, 24, 32};
+    if (size_code && sample_sizes[size_code] != info->bits_per_sample)
+        return -1;
+
+    /* UTF-8 style coded frame or sample number */
+    int pos = 4;
+    unsigned first = data[pos ++];
+    int extra;
+
+    if (! (first & 0x80))
+        extra = 0;
+    else if ((first & 0xe0) == 0xc0)
+        extra = 1;
+    else if ((first & 0xf0) == 0xe0)
+        extra = 2;
+    else if ((first & 0xf8) == 0xf0)
+        extra = 3;
+    else if ((first & 0xfc) == 0xf8)
+        extra = 4;
+    else if ((first & 0xfe) == 0xfc)
+        extra = 5;
+    else if (first == 0xfe)
+        extra = 6;
+    else
+        return -1;
+
+    int64_t number = extra ? first & (0x3f >> extra) : first;
+
+    for (int i = 0; i < extra; i ++)
+    {
+        unsigned c = data[pos ++];
+        if ((c & 0xc0) != 0x80)
+            return -1;
+
+        number = (number << 6) | (c & 0x3f);
+    }
+
+    if (block_code == 1)
+        block_size = 192;
+    else if (block_code < 6)
+        block_size = 576 << (block_code - 2);
+    else if (block_code == 6)
+        block_size = data[pos ++] + 1;
+    else if (block_code == 7)
+    {
+        block_size = ((data[pos] << 8) | data[pos + 1]) + 1;
+        pos += 2;
+    }
+    else
+        block_size = 256 << (block_code - 8);
+
+    if (rate_code == 12)
+        pos += 1;
+    else if (rate_code == 13 || rate_code == 14)
+        pos += 2;
+
+    if (crc8 (data, pos) != data[pos])
+        return -1;
+
+    /* fixed block size streams count frames rather than samples */
+    return (data[1] & 1) ? number : number * block_size;
+}
+
+/* Returns the offset of the first frame header at or after <from>, or -1.
+ * The first sample of that frame is returned in <sample>.  <buf> starts with
+ * a frame; the chain of frames is followed from there and a header is only
+ * believed if it starts exactly where the previous frame ended in samples.
+ * A sync code and CRC-8 alone turn up inside compressed data too often, and
+ * cutting a frame in two would garble the audio at the seam. */
+static int find_frame_boundary (const Index<char> & buf, int from,
+ const callback_info * info, int64_t & sample)
+{
+    auto data = (const unsigned char *) buf.begin ();
+    int len = buf.len ();
+    unsigned block_size;
+
+    int64_t number = check_frame_header (data, len, info, block_size);
+    if (number < 0)
+        return -1;
+
+    int64_t expected = number + block_size;
+
+    for (int pos = 1; pos < len - 16; pos ++)
+    {
+        if (data[pos] != 0xff)
+            continue;
+
+        number = check_frame_header (data + pos, len - pos, info, block_size);
+        if (number != expected)
+            continue;
+
+        if (pos >= from)
+        {
+            sample = number;
+            return pos;
+        }
+
+        expected = number + block_size;
+    }
+
+    return -1;
+}
+
+static FLAC__StreamDecoderReadStatus worker_read (const FLAC__StreamDecoder *,
+ FLAC__byte buffer[], size_t * bytes, void * client_data)
+{
+    auto worker = (ParallelWorker *) client_data;
+    const Index<char> & input = worker->job->input;
+
+    size_t avail = input.len () - worker->read_pos;
+    if (* bytes > avail)
+        * bytes = avail;
+
+    if (! * bytes)
+        return FLAC__STREAM_DECODER_READ_STATUS_END_OF_STREAM;
+
+    memcpy (buffer, input.begin () + worker->read_pos, * bytes);
+    worker->read_pos += * bytes;
+
+    return FLAC__STREAM_DECODER_READ_STATUS_CONTINUE;
+}
+
+static FLAC__StreamDecoderWriteStatus worker_write (const FLAC__StreamDecoder *,
+ const FLAC__Frame * frame, const FLAC__int32 * const buffer[], void * client_data)
+{
+    auto worker = (ParallelWorker *) client_data;
+    unsigned channels = worker->pool->m_channels;
+    unsigned bits = worker->pool->m_bits_per_sample;
+
+    if (frame->header.channels != channels)
+        return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
+
+    int32_t * wp = worker->frame_buffer.begin ();
+
+    for (unsigned sample = 0; sample < frame->header.blocksize; sample ++)
+    {
+        for (unsigned channel = 0; channel < channels; channel ++)
+            * (wp ++) = buffer[channel][sample];
+    }
+
+    unsigned count = frame->header.blocksize * channels;
+    Index<char> & output = worker->job->output;
+    int old_len = output.len ();
+
+    output.resize (old_len + count * SAMPLE_SIZE (bits));
+    squeeze_audio (worker->frame_buffer.begin (), output.begin () + old_len, count, bits);
+
+    return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
+}
+
+static void worker_error (const FLAC__StreamDecoder *,
+ FLAC__StreamDecoderErrorStatus status, void *)
+{
+    AUDDBG ("FLAC worker decoder error: %s\n",
+     FLAC__StreamDecoderErrorStatusString[status]);
+}
+
+void * ParallelPool::worker_thread (void * data)
+{
+    auto worker = (ParallelWorker *) data;
+    ParallelPool * pool = worker->pool;
+
+    pthread_mutex_lock (& pool->m_mutex);
+
+    while (! pool->m_quit)
+    {
+        if (pool->m_dispatched >= pool->m_queue.len ())
+        {
+            pthread_cond_wait (& pool->m_work_cond, & pool->m_mutex);
+            continue;
+        }
+
+        worker->job = pool->m_queue[pool->m_dispatched ++];
+        worker->read_pos = 0;
+
+        pthread_mutex_unlock (& pool->m_mutex);
+
+        if (! FLAC__stream_decoder_reset (worker->decoder) ||
+            ! FLAC__stream_decoder_process_until_end_of_stream (worker->decoder))
+            AUDERR ("FLAC worker failed to decode %d bytes!\n", worker->job->input.len ());
+
+        pthread_mutex_lock (& pool->m_mutex);
+
+        worker->job->done = true;
+        worker->job = nullptr;
+        pthread_cond_broadcast (& pool->m_done_cond);
+    }
+
+    pthread_mutex_unlock (& pool->m_mutex);
+    return nullptr;
+}
+
+bool ParallelPool::start (int threads)
+{
+    m_workers.insert (0, threads);
+
+    for (ParallelWorker & worker : m_workers)
+    {
+        worker.pool = this;
+        worker.frame_buffer.resize (BUFFER_SIZE_SAMP);
+
+        if (! (worker.decoder = FLAC__stream_decoder_new ()))
+            return false;
+
+        if (FLAC__stream_decoder_init_stream (worker.decoder, worker_read,
+         nullptr, nullptr, nullptr, nullptr, worker_write, nullptr,
+         worker_error, & worker) != FLAC__STREAM_DECODER_INIT_STATUS_OK)
+            return false;
+
+        if (pthread_create (& worker.thread, nullptr, worker_thread, & worker))
+            return false;
+
+        m_running ++;
+    }
+
+    return true;
+}
+
+void ParallelPool::stop ()
+{
+    flush ();
+
+    pthread_mutex_lock (& m_mutex);
+    m_quit = true;
+    pthread_cond_broadcast (& m_work_cond);
+    pthread_mutex_unlock (& m_mutex);
+
+    for (int i = 0; i < m_running; i ++)
+        pthread_join (m_workers[i].thread, nullptr);
+
+    for (ParallelWorker & worker : m_workers)
+    {
+        if (worker.decoder)
+            FLAC__stream_decoder_delete (worker.decoder);
+    }
+
+    m_workers.clear ();
+    m_running = 0;
+}
+
+void ParallelPool::submit (ParallelJob * job)
+{
+    pthread_mutex_lock (& m_mutex);
+    m_queue.append (job);
+    pthread_cond_signal (& m_work_cond);
+    pthread_mutex_unlock (& m_mutex);
+}
+
+int ParallelPool::pending ()
+{
+    pthread_mutex_lock (& m_mutex);
+    int len = m_queue.len ();
+    pthread_mutex_unlock (& m_mutex);
+    return len;
+}
+
+ParallelJob * ParallelPool::wait_front ()
+{
+    pthread_mutex_lock (& m_mutex);
+
+    ParallelJob * job = m_queue.len () ? m_queue[0] : nullptr;
+    while (job && ! job->done)
+        pthread_cond_wait (& m_done_cond, & m_mutex);
+
+    pthread_mutex_unlock (& m_mutex);
+    return job;
+}
+
+void ParallelPool::pop_front ()
+{
+    pthread_mutex_lock (& m_mutex);
+
+    delete m_queue[0];
+    m_queue.remove (0, 1);
+    m_dispatched --;
+
+    pthread_mutex_unlock (& m_mutex);
+}
+
+/* drops all queued jobs and waits for the running ones to finish */
+void ParallelPool::flush ()
+{
+    pthread_mutex_lock (& m_mutex);
+
+    /* nothing beyond this point will be picked up by the workers */
+    for (int i = m_dispatched; i < m_queue.len (); i ++)
+        delete m_queue[i];
+
+    m_queue.remove (m_dispatched, -1);
+
+    for (int i = 0; i < m_queue.len (); i ++)
+    {
+        while (! m_queue[i]->done)
+            pthread_cond_wait (& m_done_cond, & m_mutex);
+
+        delete m_queue[i];
+    }
+
+    m_queue.clear ();
+    m_dispatched = 0;
+
+    pthread_mutex_unlock (& m_mutex);
+}
+
+int flac_parallel_threads (VFSFile & file, const callback_info * info)
+{
+    if (! aud_get_bool ("flacng", "parallel_decode"))
+        return 1;
+
+    if (file.fsize () < MIN_FILE_SIZE ||
+     (int64_t) info->sample_rate * info->channels * info->bits_per_sample < MIN_SAMPLE_BITS)
+        return 1;
+
+    int threads = aud_get_int ("flacng", "parallel_threads");
+    if (threads <= 0)
+        threads = g_get_num_processors ();
+
+    return aud::clamp (threads, 1, MAX_THREADS);
+}
+
+/* Reads the STREAMINFO block and marks it as the last metadata block so that
+ * it can be prepended to each job. */
+static bool read_stream_header (VFSFile & file, Index<char> & header)
+{
+    header.resize (STREAM_HEADER_SIZE);
+
+    if (file.fseek (0, VFS_SEEK_SET) != 0 ||
+        file.fread (header.begin (), 1, STREAM_HEADER_SIZE) != STREAM_HEADER_SIZE)
+        return false;
+
+    auto data = (unsigned char *) header.begin ();
+
+    if (memcmp (data, "fLaC", 4) || (data[4] & 0x7f) != FLAC__METADATA_TYPE_STREAMINFO ||
+        data[5] != 0 || data[6] != 0 || data[7] != 34)
+        return false;
+
+    data[4] |= 0x80;
+    return true;
+}
+
+/* Seeks with the main decoder, which also decodes the remainder of the target
+ * frame, then positions the file at the first frame after it. */
+static bool seek_main_decoder (VFSFile & file, FLAC__StreamDecoder * decoder,
+ callback_info * info, int64_t sample, Index<char> & buffer)
+{
+    info->reset ();
+
+    if (! flac_seek (decoder, info, sample))
+    {
+        AUDERR ("Could not seek to sample %ld!\n", (long) sample);
+        FLAC__stream_decoder_flush (decoder);
+        info->reset ();
+        return false;
+    }
+
+    buffer.resize (info->buffer_used * SAMPLE_SIZE (info->bits_per_sample));
+    squeeze_audio (info->output_buffer.begin (), buffer.begin (),
+     info->buffer_used, info->bits_per_sample);
+
+    info->reset ();
+
+    FLAC__uint64 offset;
+    return FLAC__stream_decoder_get_decode_position (decoder, & offset) &&
+     file.fseek (offset, VFS_SEEK_SET) == 0;
+}
+
+bool FLACng::play_parallel (VFSFile & file, FLAC__StreamDecoder * decoder,
+ callback_info * info, int threads)
+{
+    Index<char> header, carry, partial;
+    FLAC__uint64 offset;
+    int64_t carry_offset;
+
+    /* position of the first frame */
+    if (! FLAC__stream_decoder_get_decode_position (decoder, & offset) ||
+        ! read_stream_header (file, header) ||
+        file.fseek (offset, VFS_SEEK_SET) != 0)
+    {
+        AUDERR ("Could not set up parallel decoding!\n");
+        return false;
+    }
+
+    carry_offset = offset;
+
+    ParallelPool pool (info->bits_per_sample, info->channels);
+
+    if (! pool.start (threads))
+    {
+        AUDERR ("Could not start FLAC worker threads!\n");
+        return false;
+    }
+
+    AUDDBG ("Decoding with %d threads.\n", threads);
+
+    bool eof = false;
+
+    while (! check_stop ())
+    {
+        int seek_value = check_seek ();
+        if (seek_value >= 0)
+        {
+            pool.flush ();
+            carry.clear ();
+            eof = ! seek_main_decoder (file, decoder, info,
+             (int64_t) seek_value * info->sample_rate / 1000, partial);
+            carry_offset = file.ftell ();
+
+            write_audio (partial.begin (), partial.len ());
+        }
+
+        while (! eof && pool.pending () < 2 * threads)
+        {
+            int old_len = carry.len ();
+            carry.resize (old_len + JOB_SIZE);
+
+            int64_t read = file.fread (carry.begin () + old_len, 1, JOB_SIZE);
+            carry.resize (old_len + aud::max (read, (int64_t) 0));
+
+            if (read <= 0)
+                eof = true;
+
+            int64_t sample = -1;
+            int cut = eof ? carry.len () : find_frame_boundary (carry, JOB_SIZE, info, sample);
+
+            if (cut < 0 && carry.len () >= MAX_CARRY)
+            {
+                AUDERR ("No frame boundary found in %d bytes!\n", carry.len ());
+                cut = carry.len ();
+            }
+
+            if (cut <= 0)
+                continue;
+
+            auto job = new ParallelJob;
+            job->input.insert (header.begin (), 0, header.len ());
+            job->input.insert (carry.begin (), -1, cut);
+            carry.remove (0, cut);
+            carry_offset += cut;
+
+            if (info->seek_table && sample >= 0)
+                info->seek_table->add (sample, carry_offset);
+
+            pool.submit (job);
+        }
+
+        ParallelJob * job = pool.wait_front ();
+        if (! job)
+            break;
+
+        write_audio (job->output.begin (), job->output.len ());
+        pool.pop_front ();
+    }
+
+    pool.stop ();
+    return true;
+}
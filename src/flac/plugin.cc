@@ -28,11 +28,31 @@ EXPORT FLACng aud_plugin_instance;
 
 static FLAC__StreamDecoder *decoder;
 static callback_info *cinfo;
+static SeekTable seek_table;
+
+const char *const FLACng::defaults[] = {
+    "parallel_decode", "FALSE",
+    "parallel_threads", "0",
+    nullptr
+};
+
+const PreferencesWidget FLACng::widgets[] = {
+    WidgetLabel(N_("<b>Decoding</b>")),
+    WidgetCheck(N_("Use multiple threads for high-resolution files"),
+        WidgetBool("flacng", "parallel_decode")),
+    WidgetSpin(N_("Threads (0 = automatic):"),
+        WidgetInt("flacng", "parallel_threads"),
+        {0, 16, 1})
+};
+
+const PluginPreferences FLACng::prefs = {{widgets}};
 
 bool FLACng::init()
 {
     FLAC__StreamDecoderInitStatus ret;
 
+    aud_config_set_defaults("flacng", defaults);
+
     /* Callback structure and decoder for main decoding loop */
 
     cinfo = new callback_info;
@@ -43,6 +63,9 @@ bool FLACng::init()
         return false;
     }
 
+    /* Only used to decide whether our own seek table is needed */
+    FLAC__stream_decoder_set_metadata_respond(decoder, FLAC__METADATA_TYPE_SEEKTABLE);
+
     if (FLAC__STREAM_DECODER_INIT_STATUS_OK != (ret = FLAC__stream_decoder_init_stream(
         decoder,
         read_callback,
@@ -81,7 +104,7 @@ bool FLACng::is_our_file(const char *filename, VFSFile &file)
     return ! strncmp (buf, "fLaC", sizeof buf);
 }
 
-static void squeeze_audio(int32_t* src, void* dst, unsigned count, unsigned res)
+void squeeze_audio(int32_t* src, void* dst, unsigned count, unsigned res)
 {
     int32_t* rp = src;
     int8_t*  wp = (int8_t*) dst;
@@ -115,6 +138,7 @@ bool FLACng::play(const char *filename, VFSFile &file)
 {
     Index<char> play_buffer;
     bool error = false;
+    int threads;
 
     cinfo->fd = &file;
 
@@ -125,11 +149,23 @@ bool FLACng::play(const char *filename, VFSFile &file)
         goto ERR_NO_CLOSE;
     }
 
+    if (! cinfo->has_seektable)
+    {
+        seek_table.load(filename, cinfo, file.fsize());
+        cinfo->seek_table = &seek_table;
+    }
+
     play_buffer.resize(BUFFER_SIZE_BYTE);
 
     set_stream_bitrate(cinfo->bitrate);
     open_audio(SAMPLE_FMT(cinfo->bits_per_sample), cinfo->sample_rate, cinfo->channels);
 
+    if ((threads = flac_parallel_threads(file, cinfo)) > 1)
+    {
+        error = ! play_parallel(file, decoder, cinfo, threads);
+        goto ERR_NO_CLOSE;
+    }
+
     while (FLAC__stream_decoder_get_state(decoder) != FLAC__STREAM_DECODER_END_OF_STREAM)
     {
         if (check_stop ())
@@ -137,7 +173,7 @@ bool FLACng::play(const char *filename, VFSFile &file)
 
         int seek_value = check_seek ();
         if (seek_value >= 0)
-            FLAC__stream_decoder_seek_absolute (decoder, (int64_t)
+            flac_seek (decoder, cinfo, (int64_t)
              seek_value * cinfo->sample_rate / 1000);
 
         /* Try to decode a single frame of audio */
@@ -159,6 +195,12 @@ bool FLACng::play(const char *filename, VFSFile &file)
 ERR_NO_CLOSE:
     cinfo->reset();
 
+    if (cinfo->seek_table)
+    {
+        seek_table.save(filename, cinfo, file.fsize());
+        cinfo->seek_table = nullptr;
+    }
+
     if (FLAC__stream_decoder_flush(decoder) == false)
         AUDERR("Could not flush decoder state!\n");
 
@@ -125,6 +125,13 @@ FLAC__StreamDecoderWriteStatus write_callback(const FLAC__StreamDecoder *decoder
     if (!info->output_buffer.len())
         info->alloc();
 
+    info->frame_sample = frame->header.number.sample_number;
+
+    /* the decoder is now positioned at the start of the following frame */
+    FLAC__uint64 offset;
+    if (info->seek_table && FLAC__stream_decoder_get_decode_position(decoder, &offset))
+        info->seek_table->add(frame->header.number.sample_number + frame->header.blocksize, offset);
+
     for (unsigned sample = 0; sample < frame->header.blocksize; sample++)
     {
         for (unsigned channel = 0; channel < frame->header.channels; channel++)
@@ -169,5 +176,12 @@ void metadata_callback(const FLAC__StreamDecoder *decoder, const FLAC__StreamMet
             info->bitrate = 8 * size * (int64_t) info->sample_rate / info->total_samples;
 
         AUDDBG("bitrate=%d\n", info->bitrate);
+
+        memcpy(info->md5sum, metadata->data.stream_info.md5sum, sizeof info->md5sum);
+    }
+    else if (metadata->type == FLAC__METADATA_TYPE_SEEKTABLE)
+    {
+        info->has_seektable = (metadata->data.seek_table.num_points > 0);
+        AUDDBG("seektable points=%d\n", metadata->data.seek_table.num_points);
     }
 }
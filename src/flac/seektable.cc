@@ -0,0 +1,197 @@
+/*
+ *  A FLAC decoder plugin for the Audacious Media Player
+ *  Copyright (C) 2026 Audacious developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Synthesized seek table for files without a SEEKTABLE block.  Without one,
+ * libFLAC seeks by bisecting the byte stream, which costs a seek and a read
+ * per probe and is painfully slow over the network.  Instead we note the
+ * byte offset of a frame about once per second while decoding, and seek by
+ * jumping to the closest earlier point and decoding forward from there.
+ * The points are kept in a small cache file so that they survive restarts.
+ */
+
+#include <string.h>
+
+#include <libaudcore/runtime.h>
+
+#include "flacng.h"
+#include "../plugin-common/disk-cache.h"
+
+/* at most 8 MB of seek tables, i.e. a few thousand files */
+static DiskCache cache("flac-seektables", "FLST", 2, 8 << 20);
+
+/* decode at most this many seconds forward from a cached point */
+#define MAX_GAP 10
+
+struct CacheHeader
+{
+    int64_t total_samples;
+    uint32_t sample_rate;
+    uint32_t n_points;
+    FLAC__byte md5sum[16];
+};
+
+static bool header_matches(const CacheHeader &header, const callback_info *info)
+{
+    return header.total_samples == (int64_t) info->total_samples &&
+     header.sample_rate == info->sample_rate &&
+     ! memcmp(header.md5sum, info->md5sum, sizeof header.md5sum);
+}
+
+void SeekTable::load(const char *filename, const callback_info *info, int64_t file_size)
+{
+    m_points.clear();
+    m_interval = info->sample_rate;
+    m_dirty = false;
+
+    if (file_size <= 0 || ! info->sample_rate)
+        return;
+
+    Index<char> data;
+    CacheHeader header;
+
+    if (! cache.load(filename, file_size, data) || data.len() < (int) sizeof header)
+        return;
+
+    memcpy(&header, data.begin(), sizeof header);
+
+    if (! header_matches(header, info) ||
+     header.n_points > (uint32_t) (data.len() / sizeof(SeekPoint)) ||
+     (size_t) data.len() != sizeof header + header.n_points * sizeof(SeekPoint))
+    {
+        AUDDBG("Ignoring stale seek table cache for %s\n", filename);
+        return;
+    }
+
+    m_points.insert((const SeekPoint *) (data.begin() + sizeof header), 0, header.n_points);
+    AUDDBG("Loaded %d cached seek points for %s\n", m_points.len(), filename);
+}
+
+void SeekTable::save(const char *filename, const callback_info *info, int64_t file_size)
+{
+    if (! m_dirty || file_size <= 0)
+        return;
+
+    CacheHeader header = CacheHeader();
+    header.total_samples = info->total_samples;
+    header.sample_rate = info->sample_rate;
+    header.n_points = m_points.len();
+    memcpy(header.md5sum, info->md5sum, sizeof header.md5sum);
+
+    Index<char> data;
+    disk_cache_append(data, &header, 1);
+    disk_cache_append(data, m_points.begin(), m_points.len());
+
+    cache.save(filename, file_size, data);
+    m_dirty = false;
+}
+
+/* index of the last point at or before <sample>, or -1 */
+int SeekTable::find(int64_t sample) const
+{
+    int low = 0, high = m_points.len();
+
+    while (low < high)
+    {
+        int mid = (low + high) / 2;
+
+        if (m_points[mid].sample <= sample)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return low - 1;
+}
+
+void SeekTable::add(int64_t sample, int64_t offset)
+{
+    if (! m_interval)
+        return;
+
+    int pos = find(sample);
+
+    /* keep the points about one interval apart */
+    if (pos >= 0 && sample - m_points[pos].sample < m_interval)
+        return;
+    if (pos + 1 < m_points.len() && m_points[pos + 1].sample - sample < m_interval)
+        return;
+
+    /* a cached point disagreeing with the stream means the cache is bogus */
+    if ((pos >= 0 && m_points[pos].offset >= offset) ||
+        (pos + 1 < m_points.len() && m_points[pos + 1].offset <= offset))
+    {
+        AUDDBG("Inconsistent seek point, discarding seek table.\n");
+        m_points.clear();
+        pos = -1;
+    }
+
+    m_points.insert(pos + 1, 1);
+    m_points[pos + 1] = {sample, offset};
+    m_dirty = true;
+}
+
+/* Same contract as FLAC__stream_decoder_seek_absolute(): on success, the
+ * output buffer holds the decoded samples starting at <sample>. */
+bool flac_seek(FLAC__StreamDecoder *decoder, callback_info *info, int64_t sample)
+{
+    SeekTable *table = info->seek_table;
+    int pos = table ? table->find(sample) : -1;
+
+    if (info->has_seektable || pos < 0 ||
+     sample - table->point(pos).sample > (int64_t) MAX_GAP * info->sample_rate)
+        return FLAC__stream_decoder_seek_absolute(decoder, sample);
+
+    if (info->fd->fseek(table->point(pos).offset, VFS_SEEK_SET) != 0 ||
+        ! FLAC__stream_decoder_flush(decoder))
+        return FLAC__stream_decoder_seek_absolute(decoder, sample);
+
+    while (1)
+    {
+        info->reset();
+
+        if (! FLAC__stream_decoder_process_single(decoder) ||
+         FLAC__stream_decoder_get_state(decoder) == FLAC__STREAM_DECODER_END_OF_STREAM)
+            break;
+
+        if (! info->buffer_used)
+            continue;
+
+        /* landed somewhere unexpected; let libFLAC sort it out */
+        if (info->frame_sample > sample)
+            break;
+
+        int64_t skip = (sample - info->frame_sample) * info->channels;
+
+        if (skip < info->buffer_used)
+        {
+            int32_t *data = info->output_buffer.begin();
+            memmove(data, data + skip, (info->buffer_used - skip) * sizeof(int32_t));
+            info->buffer_used -= skip;
+            info->write_pointer = data + info->buffer_used;
+            return true;
+        }
+    }
+
+    AUDDBG("Cached seek to sample %ld failed, falling back.\n", (long) sample);
+
+    info->reset();
+    FLAC__stream_decoder_flush(decoder);
+    return FLAC__stream_decoder_seek_absolute(decoder, sample);
+}
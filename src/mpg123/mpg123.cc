@@ -42,6 +42,8 @@
 #include <libaudcore/preferences.h>
 #include <audacious/audtag.h>
 
+#include "../plugin-common/disk-cache.h"
+
 class MPG123Plugin : public InputPlugin
 {
 public:
@@ -83,13 +85,16 @@ const char * const MPG123Plugin::mimes[] = {
 
 const char * const MPG123Plugin::defaults[] = {
     "full_scan", "FALSE",
+    "cache_index", "TRUE",
     nullptr
 };
 
 const PreferencesWidget MPG123Plugin::widgets[] = {
     WidgetLabel (N_("<b>Advanced</b>")),
     WidgetCheck (N_("Use accurate length calculation (slow)"),
-        WidgetBool ("mpg123", "full_scan"))
+        WidgetBool ("mpg123", "full_scan")),
+    WidgetCheck (N_("Remember length and seek index of scanned files"),
+        WidgetBool ("mpg123", "cache_index"))
 };
 
 const PluginPreferences MPG123Plugin::prefs = {{widgets}};
@@ -118,6 +123,79 @@ static off_t replace_lseek_dummy (void * file, off_t to, int whence)
     return -1;
 }
 
+/* The frame index built by mpg123_scan() or by playing a file through is
+ * saved along with the exact length, so that later opens get accurate
+ * lengths and seeking without scanning the file again. */
+
+/* at most 32 MB of frame indexes */
+static DiskCache index_cache ("mpg123-index", "MPIX", 2, 32 << 20);
+
+struct IndexCacheHeader
+{
+    int64_t length;  // in samples
+    int64_t step;
+    int64_t fill;
+};
+
+static bool load_index (const char * filename, VFSFile & file,
+ mpg123_handle * dec, int64_t & length)
+{
+    Index<char> data;
+    IndexCacheHeader header;
+
+    if (! index_cache.load (filename, file.fsize (), data) || data.len () < (int) sizeof header)
+        return false;
+
+    memcpy (& header, data.begin (), sizeof header);
+
+    /* bound fill before using it, so that the size check cannot overflow */
+    if (header.fill < 1 || header.fill > (int64_t) (data.len () / sizeof (int64_t)) ||
+     (int64_t) data.len () != (int64_t) (sizeof header + header.fill * sizeof (int64_t)))
+        return false;
+
+    auto cached = (const int64_t *) (data.begin () + sizeof header);
+
+    Index<off_t> offsets;
+    offsets.insert (0, header.fill);
+
+    for (int i = 0; i < header.fill; i ++)
+        offsets[i] = cached[i];
+
+    if (mpg123_set_index (dec, offsets.begin (), header.step, header.fill) != MPG123_OK)
+        return false;
+
+    length = header.length;
+    AUDDBG ("Using cached frame index for %s.\n", filename);
+    return true;
+}
+
+static void save_index (const char * filename, VFSFile & file,
+ mpg123_handle * dec, int64_t length)
+{
+    off_t * offsets, step;
+    size_t fill;
+
+    if (length <= 0 || mpg123_index (dec, & offsets, & step, & fill) != MPG123_OK || ! fill)
+        return;
+
+    IndexCacheHeader header = IndexCacheHeader ();
+    header.length = length;
+    header.step = step;
+    header.fill = fill;
+
+    Index<int64_t> points;
+    points.insert (0, fill);
+
+    for (size_t i = 0; i < fill; i ++)
+        points[i] = offsets[i];
+
+    Index<char> data;
+    disk_cache_append (data, & header, 1);
+    disk_cache_append (data, points.begin (), points.len ());
+
+    index_cache.save (filename, file.fsize (), data);
+}
+
 bool MPG123Plugin::init ()
 {
     aud_config_set_defaults ("mpg123", defaults);
@@ -145,6 +223,7 @@ struct DecodeState
 
     long rate;
     int channels, encoding;
+    int64_t length = -1;  // exact length in samples, if known
     mpg123_frameinfo info;
     size_t bytes_read;
     float buf[4096];
@@ -169,8 +248,24 @@ bool DecodeState::init (const char * filename, VFSFile & file, bool probing, boo
     if (mpg123_open_handle (dec, & file) < 0)
         goto err;
 
-    if (! stream && aud_get_bool ("mpg123", "full_scan") && mpg123_scan (dec) < 0)
-        goto err;
+    /* the length is not needed for probing */
+    if (! stream && ! probing)
+    {
+        bool cache = aud_get_bool ("mpg123", "cache_index");
+
+        if (cache && load_index (filename, file, dec, length))
+            ;
+        else if (aud_get_bool ("mpg123", "full_scan"))
+        {
+            if (mpg123_scan (dec) < 0)
+                goto err;
+
+            length = mpg123_length (dec);
+
+            if (cache)
+                save_index (filename, file, dec, length);
+        }
+    }
 
     while (1)
     {
@@ -217,10 +312,96 @@ static bool detect_id3 (VFSFile & file)
     return is_id3;
 }
 
-static StringBuf make_format_string (const mpg123_frameinfo * info)
+static StringBuf make_format_string (int version, int layer)
 {
     static const char * vers[] = {"1", "2", "2.5"};
-    return str_printf ("MPEG-%s layer %d", vers[info->version], info->layer);
+    return str_printf ("MPEG-%s layer %d", vers[version], layer);
+}
+
+static StringBuf make_format_string (const mpg123_frameinfo * info)
+{
+    return make_format_string (info->version, info->layer);
+}
+
+/* Quick content probe: instead of setting up a decoder, check that the file
+ * starts with a few consecutive, consistent MPEG audio frame headers. */
+
+#define PROBE_FRAMES 3
+#define PROBE_BUFSIZE 8192  // enough for three of the largest frames
+
+struct FrameHeader
+{
+    int version;  // 0 = MPEG-1, 1 = MPEG-2, 2 = MPEG-2.5
+    int layer;
+    int rate;
+    int length;
+};
+
+static bool parse_frame_header (const unsigned char * p, FrameHeader & h)
+{
+    static const short bitrates[2][3][15] = {
+        {{0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448},
+         {0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384},
+         {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320}},
+        {{0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256},
+         {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160},
+         {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160}}
+    };
+
+    static const int rates[3] = {44100, 48000, 32000};
+
+    if (p[0] != 0xff || (p[1] & 0xe0) != 0xe0)
+        return false;
+
+    int version_bits = (p[1] >> 3) & 3;
+    int layer_bits = (p[1] >> 1) & 3;
+    int bitrate_index = p[2] >> 4;
+    int rate_index = (p[2] >> 2) & 3;
+    int padding = (p[2] >> 1) & 1;
+
+    /* free format streams have no fixed frame length; leave them to mpg123 */
+    if (version_bits == 1 || ! layer_bits || ! bitrate_index ||
+     bitrate_index == 15 || rate_index == 3 || (p[3] & 3) == 2)
+        return false;
+
+    h.version = (version_bits == 3) ? 0 : (version_bits == 2) ? 1 : 2;
+    h.layer = 4 - layer_bits;
+    h.rate = rates[rate_index] >> h.version;
+
+    int bitrate = bitrates[h.version ? 1 : 0][h.layer - 1][bitrate_index] * 1000;
+
+    if (h.layer == 1)
+        h.length = (12 * bitrate / h.rate + padding) * 4;
+    else if (h.layer == 3 && h.version)
+        h.length = 72 * bitrate / h.rate + padding;
+    else
+        h.length = 144 * bitrate / h.rate + padding;
+
+    return true;
+}
+
+static bool probe_frame_headers (VFSFile & file, FrameHeader & first)
+{
+    unsigned char buf[PROBE_BUFSIZE];
+    int64_t len = file.fread (buf, 1, sizeof buf);
+    int pos = 0;
+
+    for (int frame = 0; frame < PROBE_FRAMES; frame ++)
+    {
+        FrameHeader h;
+
+        if (pos + 4 > len || ! parse_frame_header (buf + pos, h))
+            return false;
+
+        if (! frame)
+            first = h;
+        else if (h.version != first.version || h.layer != first.layer || h.rate != first.rate)
+            return false;
+
+        pos += h.length;
+    }
+
+    return true;
 }
 
 bool MPG123Plugin::is_our_file (const char * filename, VFSFile & file)
@@ -233,6 +414,18 @@ bool MPG123Plugin::is_our_file (const char * filename, VFSFile & file)
     if (detect_id3 (file))
         return true;
 
+    FrameHeader header;
+    if (probe_frame_headers (file, header))
+    {
+        AUDDBG ("Accepted as %s: %s.\n", (const char *)
+         make_format_string (header.version, header.layer), filename);
+        return true;
+    }
+
+    /* anything unusual (junk, free format, ...) gets a real decoder */
+    if (file.fseek (0, VFS_SEEK_SET) < 0)
+        return false;
+
     DecodeState s;
     if (! s.init (filename, file, true, stream))
         return false;
@@ -257,7 +450,7 @@ static bool read_mpg123_info (const char * filename, VFSFile & file, Tuple & tup
 
     if (! stream)
     {
-        int64_t samples = mpg123_length (s.dec);
+        int64_t samples = (s.length >= 0) ? s.length : mpg123_length (s.dec);
         int length = (s.rate > 0) ? samples * 1000 / s.rate : 0;
 
         if (length > 0)
@@ -309,6 +502,7 @@ bool MPG123Plugin::play (const char * filename, VFSFile & file)
     int bitrate = s.info.bitrate * 1000;
     int bitrate_sum = 0, bitrate_count = 0;
     int error_count = 0;
+    bool seeked = false;
 
     set_stream_bitrate (bitrate);
 
@@ -327,6 +521,7 @@ bool MPG123Plugin::play (const char * filename, VFSFile & file)
                 print_mpg123_error (filename, s.dec);
 
             s.bytes_read = 0;
+            seeked = true;
         }
 
         mpg123_info (s.dec, & s.info);
@@ -349,7 +544,15 @@ bool MPG123Plugin::play (const char * filename, VFSFile & file)
             int ret = mpg123_read (s.dec, (unsigned char *) s.buf, sizeof s.buf, & s.bytes_read);
 
             if (ret == MPG123_DONE || ret == MPG123_ERR_READER)
+            {
+                /* after an uninterrupted run, the index covers the whole
+                 * file and the position is the exact length */
+                if (ret == MPG123_DONE && ! stream && ! seeked && s.length < 0 &&
+                 aud_get_bool ("mpg123", "cache_index"))
+                    save_index (filename, file, s.dec, mpg123_tell (s.dec));
+
                 break;
+            }
 
             if (ret < 0)
             {
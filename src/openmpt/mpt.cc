@@ -30,6 +30,7 @@
 #include <libaudcore/runtime.h>
 
 #include "mptwrap.h"
+#include "../plugin-common/output-rate.h"
 
 static bool force_apply = false;
 
@@ -37,6 +38,14 @@ static constexpr const char *CFG_SECTION               = "openmpt";
 static constexpr const char *SETTING_STEREO_SEPARATION = "stereo_separation";
 static constexpr const char *SETTING_INTERPOLATOR      = "interpolator";
 
+/* libopenmpt renders at any rate between 8 and 192 kHz, so if a resampling
+ * effect is enabled, render at its output rate directly. */
+static int output_rate()
+{
+    int rate = effect_output_rate(MPTWrap::default_rate);
+    return (rate >= 8000 && rate <= 192000) ? rate : MPTWrap::default_rate;
+}
+
 class MPTPlugin : public InputPlugin
 {
 public:
@@ -103,6 +112,7 @@ public:
 
         force_apply = true;
 
+        mpt.set_rate(output_rate());
         open_audio(FMT_FLOAT, mpt.rate(), mpt.channels());
 
         while (!check_stop())
@@ -63,7 +63,10 @@ public:
     int64_t read(float *, int64_t);
     void seek(int pos);
 
-    static constexpr int rate() { return 48000; }
+    static constexpr int default_rate = 48000;
+
+    void set_rate(int rate) { m_rate = rate; }
+    int rate() const { return m_rate; }
     static constexpr int channels() { return 2; }
 
     int duration() const { return m_duration; }
@@ -80,6 +83,7 @@ private:
 
     SmartPtr<openmpt_module, openmpt_module_destroy> mod;
 
+    int m_rate = default_rate;
     int m_duration = 0;
     String m_title;
     String m_format;
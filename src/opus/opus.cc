@@ -0,0 +1,470 @@
+/*
+ * Ogg Opus Decoder Plugin for Audacious
+ * Copyright (C) 2026 Audacious Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <opusfile.h>
+
+#define WANT_VFS_STDIO_COMPAT
+#include <libaudcore/audstrings.h>
+#include <libaudcore/i18n.h>
+#include <libaudcore/plugin.h>
+#include <libaudcore/runtime.h>
+
+#include "../plugin-common/disk-cache.h"
+
+/* Opus always decodes at 48 kHz; libopusfile takes care of the pre-skip at
+ * the start and the trimming at the end of each link, so playback is
+ * gapless without any work on our side. */
+#define OPUS_RATE 48000
+
+/* 120 ms, the longest possible Opus packet */
+#define PCM_FRAMES 5760
+#define PCM_CHANNELS 8
+
+class OpusPlugin : public InputPlugin
+{
+public:
+    static const char about[];
+    static const char * const exts[], * const mimes[];
+
+    static constexpr PluginInfo info = {
+        N_("Ogg Opus Decoder"),
+        PACKAGE,
+        about
+    };
+
+    constexpr OpusPlugin () : InputPlugin (info, InputInfo ()
+        .with_exts (exts)
+        .with_mimes (mimes)) {}
+
+    bool is_our_file (const char * filename, VFSFile & file);
+    bool read_tag (const char * filename, VFSFile & file, Tuple & tuple, Index<char> * image);
+    bool play (const char * filename, VFSFile & file);
+};
+
+EXPORT OpusPlugin aud_plugin_instance;
+
+static int opcb_read (void * file, unsigned char * buffer, int bytes)
+{
+    return ((VFSFile *) file)->fread (buffer, 1, bytes);
+}
+
+static int opcb_seek (void * file, opus_int64 offset, int whence)
+{
+    return ((VFSFile *) file)->fseek (offset, to_vfs_seek_type (whence));
+}
+
+static opus_int64 opcb_tell (void * file)
+{
+    return ((VFSFile *) file)->ftell ();
+}
+
+static const OpusFileCallbacks opus_callbacks = {
+    opcb_read,
+    opcb_seek,
+    opcb_tell,
+    nullptr
+};
+
+static const OpusFileCallbacks opus_callbacks_stream = {
+    opcb_read,
+    nullptr,
+    nullptr,
+    nullptr
+};
+
+static OggOpusFile * open_file (VFSFile & file, bool stream)
+{
+    int error = 0;
+    OggOpusFile * of = op_open_callbacks (& file, stream ? & opus_callbacks_stream :
+     & opus_callbacks, nullptr, 0, & error);
+
+    if (! of)
+        AUDDBG ("op_open_callbacks failed: %d\n", error);
+
+    return of;
+}
+
+/*
+ * Page index.  libopusfile seeks by bisecting over the whole file, which is
+ * fine for local files but costs a round trip per step over the network.
+ * While playing, we remember where in the stream each second of audio was,
+ * and seek by jumping to a slightly earlier byte offset and decoding forward.
+ *
+ * A point is only taken when a read had to fetch a new page: the packet it
+ * decoded then starts the page that began where the previous read left off,
+ * so the offset and the PCM position belong to the same page.  The points
+ * are kept in a cache file, so that even the first seek after a restart
+ * avoids the bisection.
+ */
+
+#define INDEX_INTERVAL OPUS_RATE
+#define SEEK_MARGIN (2 * OPUS_RATE)
+#define MAX_GAP (10 * OPUS_RATE)
+
+struct PagePoint
+{
+    int64_t pcm, offset;
+};
+
+/* at most 8 MB of page indexes */
+static DiskCache index_cache ("opus-index", "OPIX", 1, 8 << 20);
+
+class PageIndex
+{
+public:
+    /* index of the last point at or before <pcm>, or -1 */
+    int find (int64_t pcm) const
+    {
+        int low = 0, high = m_points.len ();
+
+        while (low < high)
+        {
+            int mid = (low + high) / 2;
+
+            if (m_points[mid].pcm <= pcm)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+
+        return low - 1;
+    }
+
+    const PagePoint & operator[] (int pos) const
+        { return m_points[pos]; }
+
+    void add (int64_t pcm, int64_t offset)
+    {
+        int pos = find (pcm);
+
+        if (pos >= 0 && pcm - m_points[pos].pcm < INDEX_INTERVAL)
+            return;
+        if (pos + 1 < m_points.len () && m_points[pos + 1].pcm - pcm < INDEX_INTERVAL)
+            return;
+
+        m_points.insert (pos + 1, 1);
+        m_points[pos + 1] = {pcm, offset};
+        m_dirty = true;
+    }
+
+    void load (const char * filename, int64_t size)
+    {
+        Index<char> data;
+
+        if (! index_cache.load (filename, size, data) || data.len () % sizeof (PagePoint))
+            return;
+
+        m_points.insert ((const PagePoint *) data.begin (), 0, data.len () / sizeof (PagePoint));
+        AUDDBG ("Loaded %d cached page points for %s.\n", m_points.len (), filename);
+    }
+
+    void save (const char * filename, int64_t size)
+    {
+        if (! m_dirty)
+            return;
+
+        Index<char> data;
+        disk_cache_append (data, m_points.begin (), m_points.len ());
+
+        index_cache.save (filename, size, data);
+        m_dirty = false;
+    }
+
+private:
+    Index<PagePoint> m_points;
+    bool m_dirty = false;
+};
+
+static bool seek_to (OggOpusFile * of, const PageIndex & index, int64_t target)
+{
+    int pos = index.find (target - SEEK_MARGIN);
+
+    if (pos < 0 || target - index[pos].pcm > MAX_GAP || op_raw_seek (of, index[pos].offset))
+        return ! op_pcm_seek (of, target);
+
+    int64_t current = op_pcm_tell (of);
+
+    if (current < 0 || current > target)
+    {
+        AUDDBG ("Indexed seek landed at %ld, falling back.\n", (long) current);
+        return ! op_pcm_seek (of, target);
+    }
+
+    Index<float> skip;
+    skip.resize (PCM_FRAMES * PCM_CHANNELS);
+
+    while (current < target)
+    {
+        int channels = aud::min (op_channel_count (of, -1), PCM_CHANNELS);
+        int frames = aud::min (target - current, (int64_t) PCM_FRAMES);
+        int read = op_read_float (of, skip.begin (), frames * channels, nullptr);
+
+        if (read == OP_HOLE)
+            continue;
+        if (read <= 0)
+            return ! op_pcm_seek (of, target);
+
+        current += read;
+    }
+
+    return true;
+}
+
+bool OpusPlugin::is_our_file (const char * filename, VFSFile & file)
+{
+    unsigned char buf[4096];
+    int64_t len = file.fread (buf, 1, sizeof buf);
+
+    return len > 0 && op_test (nullptr, buf, len) == 0;
+}
+
+static void set_tuple_str (Tuple & tuple, Tuple::Field field,
+ const OpusTags * tags, const char * key)
+{
+    tuple.set_str (field, opus_tags_query (tags, key, 0));
+}
+
+static void read_tags (const OpusTags * tags, Tuple & tuple)
+{
+    const char * tmps;
+
+    set_tuple_str (tuple, Tuple::Title, tags, "TITLE");
+    set_tuple_str (tuple, Tuple::Artist, tags, "ARTIST");
+    set_tuple_str (tuple, Tuple::Album, tags, "ALBUM");
+    set_tuple_str (tuple, Tuple::AlbumArtist, tags, "ALBUMARTIST");
+    set_tuple_str (tuple, Tuple::Genre, tags, "GENRE");
+    set_tuple_str (tuple, Tuple::Comment, tags, "COMMENT");
+
+    if ((tmps = opus_tags_query (tags, "TRACKNUMBER", 0)))
+        tuple.set_int (Tuple::Track, atoi (tmps));
+    if ((tmps = opus_tags_query (tags, "DATE", 0)))
+        tuple.set_int (Tuple::Year, atoi (tmps));
+}
+
+/* try to detect when metadata has changed */
+static bool update_tuple (OggOpusFile * of, Tuple & tuple)
+{
+    const OpusTags * tags = op_tags (of, -1);
+    if (! tags)
+        return false;
+
+    String old_title = tuple.get_str (Tuple::Title);
+    const char * new_title = opus_tags_query (tags, "TITLE", 0);
+
+    if (! new_title || (old_title && ! strcmp (old_title, new_title)))
+        return false;
+
+    read_tags (tags, tuple);
+    return true;
+}
+
+/* R128 gains are Q7.8 dB relative to -23 LUFS; ReplayGain uses -18 LUFS.
+ * The header output gain is already applied by libopusfile. */
+static bool update_replay_gain (OggOpusFile * of, ReplayGainInfo * rg_info)
+{
+    const OpusTags * tags = op_tags (of, -1);
+    if (! tags)
+        return false;
+
+    const char * album_gain = opus_tags_query (tags, "R128_ALBUM_GAIN", 0);
+    const char * track_gain = opus_tags_query (tags, "R128_TRACK_GAIN", 0);
+
+    if (! album_gain && ! track_gain)
+        return false;
+
+    if (! album_gain)
+        album_gain = track_gain;
+    if (! track_gain)
+        track_gain = album_gain;
+
+    rg_info->album_gain = atoi (album_gain) / 256.0f + 5.0f;
+    rg_info->track_gain = atoi (track_gain) / 256.0f + 5.0f;
+    rg_info->album_peak = 0;
+    rg_info->track_peak = 0;
+
+    AUDDBG ("Album gain: %s (%f)\n", album_gain, rg_info->album_gain);
+    AUDDBG ("Track gain: %s (%f)\n", track_gain, rg_info->track_gain);
+
+    return true;
+}
+
+static Index<char> read_image (const char * filename, const OpusTags * tags)
+{
+    Index<char> data;
+    const char * tag = opus_tags_query (tags, "METADATA_BLOCK_PICTURE", 0);
+
+    if (! tag)
+        return data;
+
+    OpusPictureTag pic;
+    opus_picture_tag_init (& pic);
+
+    if (opus_picture_tag_parse (& pic, tag) == 0 && pic.format != OP_PIC_FORMAT_URL)
+        data.insert ((const char *) pic.data, 0, pic.data_length);
+    else
+        AUDERR ("Error parsing METADATA_BLOCK_PICTURE in %s.\n", filename);
+
+    opus_picture_tag_clear (& pic);
+    return data;
+}
+
+bool OpusPlugin::read_tag (const char * filename, VFSFile & file, Tuple & tuple,
+ Index<char> * image)
+{
+    bool stream = (file.fsize () < 0);
+
+    OggOpusFile * of = open_file (file, stream);
+    if (! of)
+        return false;
+
+    const OpusTags * tags = op_tags (of, -1);
+    int bitrate = stream ? 0 : op_bitrate (of, -1);
+
+    tuple.set_format ("Opus", op_channel_count (of, -1), OPUS_RATE,
+     aud::max (bitrate, 0) / 1000);
+
+    if (! stream)
+    {
+        int64_t samples = op_pcm_total (of, -1);
+        if (samples > 0)
+            tuple.set_int (Tuple::Length, samples * 1000 / OPUS_RATE);
+    }
+
+    if (tags)
+        read_tags (tags, tuple);
+
+    if (image && tags)
+        * image = read_image (filename, tags);
+
+    op_free (of);
+    return true;
+}
+
+bool OpusPlugin::play (const char * filename, VFSFile & file)
+{
+    Tuple tuple = get_playback_tuple ();
+    ReplayGainInfo rg_info;
+    PageIndex index;
+    Index<float> pcm;
+
+    bool stream = (file.fsize () < 0);
+    bool error = false;
+
+    OggOpusFile * of = open_file (file, stream);
+    if (! of)
+        return false;
+
+    int channels = op_channel_count (of, -1);
+    int last_link = op_current_link (of);
+
+    if (channels > PCM_CHANNELS)
+    {
+        AUDERR ("%d channels are not supported.\n", channels);
+        op_free (of);
+        return false;
+    }
+
+    set_stream_bitrate (stream ? 0 : aud::max (op_bitrate (of, -1), 0));
+
+    if (update_tuple (of, tuple))
+        set_playback_tuple (tuple.ref ());
+
+    if (update_replay_gain (of, & rg_info))
+        set_replay_gain (rg_info);
+
+    if (! stream)
+        index.load (filename, file.fsize ());
+
+    pcm.resize (PCM_FRAMES * PCM_CHANNELS);
+    open_audio (FMT_FLOAT, OPUS_RATE, channels);
+
+    while (! check_stop ())
+    {
+        int seek_value = check_seek ();
+
+        if (seek_value >= 0 && ! seek_to (of, index, (int64_t) seek_value * OPUS_RATE / 1000))
+        {
+            AUDERR ("seek failed\n");
+            error = true;
+            break;
+        }
+
+        int64_t page_pcm = stream ? -1 : op_pcm_tell (of);
+        int64_t page_offset = stream ? -1 : op_raw_tell (of);
+
+        int link = -1;
+        int frames = op_read_float (of, pcm.begin (), pcm.len (), & link);
+
+        if (frames == OP_HOLE)
+            continue;
+
+        if (frames <= 0)
+            break;
+
+        if (page_pcm >= 0 && page_offset >= 0 && op_raw_tell (of) != page_offset)
+            index.add (page_pcm, page_offset);
+
+        if (link != last_link)
+        {
+            /* each link of a chained stream may have its own layout */
+            int new_channels = op_channel_count (of, link);
+
+            if (new_channels > PCM_CHANNELS)
+            {
+                AUDERR ("%d channels are not supported.\n", new_channels);
+                error = true;
+                break;
+            }
+
+            if (update_tuple (of, tuple))
+                set_playback_tuple (tuple.ref ());
+
+            if (update_replay_gain (of, & rg_info))
+                set_replay_gain (rg_info);
+
+            if (new_channels != channels)
+            {
+                channels = new_channels;
+                open_audio (FMT_FLOAT, OPUS_RATE, channels);
+            }
+
+            last_link = link;
+        }
+
+        write_audio (pcm.begin (), frames * channels * sizeof (float));
+    }
+
+    if (! stream)
+        index.save (filename, file.fsize ());
+
+    op_free (of);
+    return ! error;
+}
+
+const char OpusPlugin::about[] =
+ N_("Audacious Ogg Opus Decoder\n\n"
+    "Based on libopusfile from the Xiph.Org Foundation:\n"
+    "https://opus-codec.org/");
+
+const char * const OpusPlugin::exts[] = {"opus", nullptr};
+const char * const OpusPlugin::mimes[] = {"audio/opus", "audio/x-opus+ogg", nullptr};
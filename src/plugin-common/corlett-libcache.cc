@@ -0,0 +1,180 @@
+/*
+ * Audacious: Cross platform multimedia player
+ * Copyright (c) 2026 Audacious Team
+ *
+ * Cache of the library files shared by the tracks of a PSF or 2SF set, so
+ * that moving on to the next track neither reads nor inflates them again.
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <utility>
+
+#include <libaudcore/audstrings.h>
+#include <libaudcore/vfs.h>
+
+#include "ao.h"
+#include "corlett.h"
+
+#define MAX_ENTRIES     8
+#define MEMORY_LIMIT    (64 * 1024 * 1024)
+
+struct LibEntry
+{
+    String path;
+    int64_t size, mtime;
+    Index<char> raw;
+    Index<char> program;   /* inflated, if anyone asked for it yet */
+    bool inflated;
+};
+
+static pthread_mutex_t s_mutex = PTHREAD_MUTEX_INITIALIZER;
+static Index<LibEntry> s_entries;   /* most recently used first */
+
+/* only local files are cached, since there is no cheap way to tell whether
+ * anything else has changed */
+static bool lib_stat(const char *path, int64_t &size, int64_t &mtime)
+{
+    StringBuf filename = uri_to_filename(path);
+    struct stat st;
+
+    if (!filename || stat(filename, &st) < 0)
+        return false;
+
+    size = st.st_size;
+    mtime = st.st_mtime;
+    return true;
+}
+
+static void copy_index(Index<char> &dest, const Index<char> &src)
+{
+    dest.clear();
+    dest.insert(src.begin(), 0, src.len());
+}
+
+static Index<char> inflate_program(Index<char> &raw)
+{
+    Index<char> program;
+    uint8_t *out;
+    uint64_t size;
+    corlett_t *c;
+
+    if (raw.len() < 16)
+        return program;
+
+    if (corlett_decode((uint8_t *)raw.begin(), raw.len(), &out, &size, &c) == AO_SUCCESS)
+    {
+        if (out)
+        {
+            program.insert((const char *)out, 0, size);
+            free(out);
+        }
+
+        free(c);
+    }
+
+    return program;
+}
+
+/* moves the entry for <path> to the front and returns true if it is still
+ * current; a stale entry is dropped */
+static bool lib_lookup(const char *path, int64_t size, int64_t mtime)
+{
+    for (int i = 0; i < s_entries.len(); i++)
+    {
+        if (strcmp(s_entries[i].path, path))
+            continue;
+
+        LibEntry entry = std::move(s_entries[i]);
+        s_entries.remove(i, 1);
+
+        if (entry.size != size || entry.mtime != mtime)
+            return false;
+
+        s_entries.insert(0, 1);
+        s_entries[0] = std::move(entry);
+        return true;
+    }
+
+    return false;
+}
+
+static void lib_add(const char *path, int64_t size, int64_t mtime,
+ const Index<char> &raw, const Index<char> *program)
+{
+    s_entries.insert(0, 1);
+
+    LibEntry &entry = s_entries[0];
+    entry.path = String(path);
+    entry.size = size;
+    entry.mtime = mtime;
+    entry.inflated = (program != nullptr);
+
+    copy_index(entry.raw, raw);
+    if (program)
+        copy_index(entry.program, *program);
+
+    /* the newest entry stays even if it is over the limit by itself */
+    int64_t total = 0;
+    for (int i = 0; i < s_entries.len(); i++)
+    {
+        total += s_entries[i].raw.len() + s_entries[i].program.len();
+
+        if (i > 0 && (i >= MAX_ENTRIES || total > MEMORY_LIMIT))
+        {
+            s_entries.remove(i, -1);
+            break;
+        }
+    }
+}
+
+Index<char> corlett_get_lib(const char *path, Index<char> *program)
+{
+    Index<char> raw;
+    int64_t size, mtime;
+    bool cacheable = lib_stat(path, size, mtime);
+
+    if (cacheable)
+    {
+        pthread_mutex_lock(&s_mutex);
+
+        if (lib_lookup(path, size, mtime))
+        {
+            LibEntry &entry = s_entries[0];
+
+            if (program && !entry.inflated)
+            {
+                entry.program = inflate_program(entry.raw);
+                entry.inflated = true;
+            }
+
+            copy_index(raw, entry.raw);
+            if (program)
+                copy_index(*program, entry.program);
+
+            pthread_mutex_unlock(&s_mutex);
+            return raw;
+        }
+
+        pthread_mutex_unlock(&s_mutex);
+    }
+
+    VFSFile file(path, "r");
+    if (file)
+        raw = file.read_all();
+
+    if (program)
+        *program = inflate_program(raw);
+
+    if (cacheable && raw.len())
+    {
+        pthread_mutex_lock(&s_mutex);
+        lib_add(path, size, mtime, raw, program);
+        pthread_mutex_unlock(&s_mutex);
+    }
+
+    return raw;
+}
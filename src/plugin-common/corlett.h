@@ -7,6 +7,10 @@
 
 // corlett.h
 
+#include <libaudcore/index.h>
+
+class VFSFile;
+
 #define MAX_UNKNOWN_TAGS			32
 
 typedef struct {
@@ -31,5 +35,10 @@ typedef struct {
 } corlett_t;
 
 int corlett_decode(uint8_t *input, uint32_t input_len, uint8_t **output, uint64_t *size, corlett_t **c);
+int corlett_read_tags(VFSFile &file, corlett_t **c);
 uint32_t psfTimeToMS(char *str);
 
+// libcache.cc; returns the file at <path>, and its program section inflated
+// into <program> if that is not null.  Files are kept in memory across tracks.
+Index<char> corlett_get_lib(const char *path, Index<char> *program);
+
@@ -0,0 +1,174 @@
+/*
+ * Audacious: Cross platform multimedia player
+ * Copyright (c) 2026 Audacious Team
+ *
+ * Per-file cache of data that is slow to compute (seek tables, frame
+ * indexes, lengths), kept in a subdirectory of the user directory.
+ */
+
+#include <string.h>
+
+#include <algorithm>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <libaudcore/audstrings.h>
+#include <libaudcore/runtime.h>
+#include <libaudcore/vfs.h>
+
+#include "disk-cache.h"
+
+/* look at the size of the directory after this many new entries */
+#define PRUNE_INTERVAL 32
+
+struct EntryHeader
+{
+    char magic[4];
+    uint32_t version;
+    int64_t file_size;
+    int64_t mtime;
+    int32_t uri_len;
+    int32_t data_len;
+};
+
+struct EntryInfo
+{
+    String path;
+    int64_t size, mtime;
+};
+
+/* 0 for files that are not local */
+static int64_t file_mtime (const char * filename)
+{
+    StringBuf path = uri_to_filename (filename);
+    GStatBuf st;
+
+    return (path && g_stat (path, & st) == 0) ? (int64_t) st.st_mtime : 0;
+}
+
+static StringBuf entry_path (const char * dir, const char * filename)
+{
+    char * digest = g_compute_checksum_for_string (G_CHECKSUM_SHA256, filename, -1);
+    StringBuf path = filename_build ({aud_get_path (AudPath::UserDir), dir, digest});
+
+    g_free (digest);
+    return path;
+}
+
+bool DiskCache::load (const char * filename, int64_t file_size, Index<char> & data) const
+{
+    VFSFile cache (filename_to_uri (entry_path (m_dir, filename)), "r");
+    if (! cache)
+        return false;
+
+    Index<char> raw = cache.read_all ();
+    EntryHeader header;
+
+    if (raw.len () < (int) sizeof header)
+        return false;
+
+    memcpy (& header, raw.begin (), sizeof header);
+
+    int uri_len = strlen (filename);
+
+    if (memcmp (header.magic, m_magic, 4) || header.version != m_version ||
+     header.file_size != file_size || header.mtime != file_mtime (filename) ||
+     header.uri_len != uri_len || header.data_len < 0 ||
+     (int64_t) raw.len () != (int64_t) sizeof header + header.uri_len + header.data_len ||
+     memcmp (raw.begin () + sizeof header, filename, uri_len))
+        return false;
+
+    data.clear ();
+    data.insert (raw.begin () + sizeof header + uri_len, 0, header.data_len);
+    return true;
+}
+
+void DiskCache::save (const char * filename, int64_t file_size, const Index<char> & data)
+{
+    StringBuf dir = filename_build ({aud_get_path (AudPath::UserDir), m_dir});
+    if (g_mkdir_with_parents (dir, 0755) != 0)
+        return;
+
+    EntryHeader header = EntryHeader ();
+    memcpy (header.magic, m_magic, 4);
+    header.version = m_version;
+    header.file_size = file_size;
+    header.mtime = file_mtime (filename);
+    header.uri_len = strlen (filename);
+    header.data_len = data.len ();
+
+    StringBuf path = entry_path (m_dir, filename);
+    StringBuf temp = str_printf ("%s.%08x", (const char *) path, g_random_int ());
+    bool written = false;
+
+    {
+        VFSFile cache (filename_to_uri (temp), "w");
+
+        if (cache)
+            written = cache.fwrite (& header, sizeof header, 1) == 1 &&
+             cache.fwrite (filename, 1, header.uri_len) == header.uri_len &&
+             cache.fwrite (data.begin (), 1, data.len ()) == data.len ();
+    }
+
+    /* rename() does not replace an existing file on Windows */
+    if (written && g_rename (temp, path) != 0)
+    {
+        g_unlink (path);
+        written = (g_rename (temp, path) == 0);
+    }
+
+    if (! written)
+    {
+        AUDERR ("Could not write %s cache entry for %s.\n", m_dir, filename);
+        g_unlink (temp);
+        return;
+    }
+
+    if (m_saves ++ % PRUNE_INTERVAL == 0)
+        prune ();
+}
+
+/* removes the oldest entries until the directory is well below the limit */
+void DiskCache::prune ()
+{
+    StringBuf dir = filename_build ({aud_get_path (AudPath::UserDir), m_dir});
+    GDir * handle = g_dir_open (dir, 0, nullptr);
+    if (! handle)
+        return;
+
+    Index<EntryInfo> entries;
+    int64_t total = 0;
+    const char * name;
+
+    while ((name = g_dir_read_name (handle)))
+    {
+        StringBuf path = filename_build ({dir, name});
+        GStatBuf st;
+
+        if (g_stat (path, & st) == 0)
+        {
+            entries.append (EntryInfo {String (path), (int64_t) st.st_size, (int64_t) st.st_mtime});
+            total += st.st_size;
+        }
+    }
+
+    g_dir_close (handle);
+
+    if (total <= m_max_size)
+        return;
+
+    std::sort (entries.begin (), entries.end (),
+     [] (const EntryInfo & a, const EntryInfo & b) { return a.mtime < b.mtime; });
+
+    for (const EntryInfo & entry : entries)
+    {
+        if (total <= m_max_size * 3 / 4)
+            break;
+
+        if (g_unlink (entry.path) == 0)
+            total -= entry.size;
+    }
+
+    AUDDBG ("Pruned %s cache to %ld bytes.\n", m_dir, (long) total);
+}
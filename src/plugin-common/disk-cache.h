@@ -0,0 +1,50 @@
+/*
+ * Audacious: Cross platform multimedia player
+ * Copyright (c) 2026 Audacious Team
+ *
+ * Per-file cache of data that is slow to compute (seek tables, frame
+ * indexes, lengths), kept in a subdirectory of the user directory.
+ */
+
+#ifndef PLUGIN_COMMON_DISK_CACHE_H
+#define PLUGIN_COMMON_DISK_CACHE_H
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include <libaudcore/index.h>
+
+/* Entries are named after a SHA-256 digest of the file's URI and record the
+ * URI, size and modification time, so data is only ever returned for the
+ * same, unchanged file.  Once the directory grows beyond <max_size> bytes,
+ * the entries written longest ago are removed. */
+class DiskCache
+{
+public:
+    DiskCache (const char * dir, const char * magic, uint32_t version, int64_t max_size) :
+        m_dir (dir),
+        m_magic (magic),
+        m_version (version),
+        m_max_size (max_size) {}
+
+    bool load (const char * filename, int64_t file_size, Index<char> & data) const;
+    void save (const char * filename, int64_t file_size, const Index<char> & data);
+
+private:
+    void prune ();
+
+    const char * const m_dir, * const m_magic;
+    const uint32_t m_version;
+    const int64_t m_max_size;
+
+    std::atomic<int> m_saves {0};
+};
+
+template<class T>
+void disk_cache_append (Index<char> & data, const T * items, int count)
+{
+    data.insert ((const char *) items, -1, count * sizeof (T));
+}
+
+#endif
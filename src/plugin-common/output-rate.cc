@@ -0,0 +1,54 @@
+/*
+ * Audacious: Cross platform multimedia player
+ * Copyright (c) 2026 Audacious Team
+ *
+ * Output rate of the resampling effects, for plugins that can render at any
+ * rate and would rather not be resampled afterwards.
+ */
+
+#include <libaudcore/audstrings.h>
+#include <libaudcore/plugins.h>
+#include <libaudcore/runtime.h>
+
+#include "output-rate.h"
+
+/* the range both resamplers clamp to */
+#define MIN_RATE 8000
+#define MAX_RATE 192000
+
+/* mirrors Resampler::start() in src/resample */
+static int resample_rate (int rate)
+{
+    int new_rate = 0;
+
+    if (aud_get_bool ("resample", "use-mappings"))
+        new_rate = aud_get_int ("resample", int_to_str (rate));
+    if (! new_rate)
+        new_rate = aud_get_int ("resample", "default-rate");
+
+    return aud::clamp (new_rate, MIN_RATE, MAX_RATE);
+}
+
+/* mirrors SoXResampler::start() in src/soxr */
+static int soxr_rate ()
+{
+    return aud::clamp (aud_get_int ("soxr", "rate"), MIN_RATE, MAX_RATE);
+}
+
+int effect_output_rate (int rate)
+{
+    PluginHandle * resample = aud_plugin_lookup_basename ("resample");
+    PluginHandle * soxr = aud_plugin_lookup_basename ("sox-resampler");
+
+    /* the list is in the order the effects are applied */
+    for (PluginHandle * plugin : aud_plugin_list (PluginType::Effect))
+    {
+        if (! plugin || (plugin != resample && plugin != soxr) ||
+         ! aud_plugin_get_enabled (plugin))
+            continue;
+
+        rate = (plugin == resample) ? resample_rate (rate) : soxr_rate ();
+    }
+
+    return rate;
+}
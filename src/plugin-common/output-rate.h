@@ -0,0 +1,17 @@
+/*
+ * Audacious: Cross platform multimedia player
+ * Copyright (c) 2026 Audacious Team
+ *
+ * Output rate of the resampling effects, for plugins that can render at any
+ * rate and would rather not be resampled afterwards.
+ */
+
+#ifndef PLUGIN_COMMON_OUTPUT_RATE_H
+#define PLUGIN_COMMON_OUTPUT_RATE_H
+
+/* Returns the rate that audio produced at <rate> leaves the effect chain
+ * at, following each enabled resampler in the order the chain runs them.
+ * Callers should still check the result against the rates they support. */
+int effect_output_rate (int rate);
+
+#endif
@@ -7,6 +7,7 @@
 #ifndef __AO_H
 #define __AO_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #define WANT_AUD_BSWAP
@@ -33,6 +34,11 @@ enum
 	COMMAND_JUMP
 };
 
-Index<char> ao_get_lib(char *filename);
+Index<char> ao_get_lib(char *filename, Index<char> *program = nullptr);
+
+// saves or restores a block of emulator state at *io, then advances *io past it
+typedef void (*ao_copy_func_t)(uint8_t **io, void *state, size_t size);
+
+#define AO_COPY_STATE(io, copy, var)	(copy)((io), (void *)&(var), sizeof(var))
 
 #endif // AO_H
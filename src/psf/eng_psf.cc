@@ -39,7 +39,7 @@
 #include "peops/registers.h"
 #include "peops/spu.h"
 
-#include "corlett.h"
+#include "../plugin-common/corlett.h"
 
 #define DEBUG_LOADER	(0)
 
@@ -112,15 +112,20 @@ int32_t psf_start(uint8_t *buffer, uint32_t length)
 		printf("Loading library: %s\n", c->lib);
 		#endif
 
-		Index<char> buf = ao_get_lib(c->lib);
+		Index<char> program;
+		Index<char> buf = ao_get_lib(c->lib, &program);
 
 		if (!buf.len())
 			return AO_FAIL;
 
-		if (corlett_decode((uint8_t *)buf.begin(), buf.len(), &lib_decoded, &lib_len, &lib) != AO_SUCCESS)
+		// the program comes inflated from the library cache, so only read the tags here
+		if (corlett_decode((uint8_t *)buf.begin(), buf.len(), nullptr, nullptr, &lib) != AO_SUCCESS)
 			return AO_FAIL;
 
-		if (strncmp((char *)lib_decoded, "PS-X EXE", 8))
+		lib_decoded = (uint8_t *)program.begin();
+		lib_len = program.len();
+
+		if (lib_len < 8 || strncmp((char *)lib_decoded, "PS-X EXE", 8))
 		{
 			printf("Major error!  PSF was OK, but referenced library is not!\n");
 			free(lib);
@@ -197,15 +202,19 @@ int32_t psf_start(uint8_t *buffer, uint32_t length)
 			printf("Loading aux library: %s\n", c->libaux[i]);
 			#endif
 
-			Index<char> buf = ao_get_lib(c->libaux[i]);
+			Index<char> program;
+			Index<char> buf = ao_get_lib(c->libaux[i], &program);
 
 			if (!buf.len())
 				return AO_FAIL;
 
-			if (corlett_decode((uint8_t *)buf.begin(), buf.len(), &alib_decoded, &alib_len, &lib) != AO_SUCCESS)
+			if (corlett_decode((uint8_t *)buf.begin(), buf.len(), nullptr, nullptr, &lib) != AO_SUCCESS)
 				return AO_FAIL;
 
-			if (strncmp((char *)alib_decoded, "PS-X EXE", 8))
+			alib_decoded = (uint8_t *)program.begin();
+			alib_len = program.len();
+
+			if (alib_len < 8 || strncmp((char *)alib_decoded, "PS-X EXE", 8))
 			{
 				printf("Major error!  PSF was OK, but referenced library is not!\n");
 				free(lib);
@@ -335,6 +344,8 @@ int32_t psf_execute(void (*update)(const void *, int))
 	int i;
 
 	while (!stop_flag) {
+		snapshot_frame();
+
 		for (i = 0; i < 44100 / 60; i++) {
 			psx_hw_slice();
 			SPUasync(384, update);
@@ -346,6 +357,13 @@ int32_t psf_execute(void (*update)(const void *, int))
 	return AO_SUCCESS;
 }
 
+void psf_copy_state(uint8_t **io, ao_copy_func_t copy)
+{
+	mips_copy_state(io, copy);
+	psx_hw_copy_state(io, copy);
+	SPUcopy_state(io, copy);
+}
+
 int32_t psf_stop(void)
 {
 	SPUclose();
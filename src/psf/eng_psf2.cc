@@ -59,7 +59,7 @@
 #include "peops2/registers.h"
 #include "peops2/spu.h"
 
-#include "corlett.h"
+#include "../plugin-common/corlett.h"
 
 #define DEBUG_LOADER	(0)
 #define MAX_FS		(32)	// maximum # of filesystems (libs and subdirectories)
@@ -567,6 +567,8 @@ int32_t psf2_execute(void (*update)(const void *, int))
 
 	while (!stop_flag)
 	{
+		snapshot_frame();
+
 		for (i = 0; i < 44100 / 60; i++)
 		{
 			SPU2async(update);
@@ -579,6 +581,14 @@ int32_t psf2_execute(void (*update)(const void *, int))
 	return AO_SUCCESS;
 }
 
+void psf2_copy_state(uint8_t **io, ao_copy_func_t copy)
+{
+	mips_copy_state(io, copy);
+	psx_hw_copy_state(io, copy);
+	SPU2copy_state(io, copy);
+	AO_COPY_STATE(io, copy, loadAddr);
+}
+
 int32_t psf2_stop(void)
 {
 	SPU2close();
@@ -215,6 +215,8 @@ int32_t spx_execute(void (*update)(const void *, int))
 
 		if (run)
 		{
+			snapshot_frame();
+
 			for (i = 0; i < 44100 / 60; i++)
 			{
 			  	spx_tick();
@@ -226,6 +228,15 @@ int32_t spx_execute(void (*update)(const void *, int))
 	return AO_SUCCESS;
 }
 
+void spx_copy_state(uint8_t **io, ao_copy_func_t copy)
+{
+	AO_COPY_STATE(io, copy, song_ptr);
+	AO_COPY_STATE(io, copy, cur_tick);
+	AO_COPY_STATE(io, copy, cur_event);
+	AO_COPY_STATE(io, copy, next_tick);
+	SPUcopy_state(io, copy);
+}
+
 int32_t spx_stop(void)
 {
 	SPUclose();
@@ -194,6 +194,11 @@ int psf_seek(u32 t)
  return(0);
 }
 
+u32 psf_tell(void)
+{
+ return sampcount;
+}
+
 static int endless;
 void setendless(int e)
 {
@@ -666,6 +671,35 @@ int SPUshutdown(void)
  return 0;
 }
 
+////////////////////////////////////////////////////////////////////////
+// SPUCOPYSTATE: save or restore everything that changes while playing;
+// pointers stay valid until SPUclose
+////////////////////////////////////////////////////////////////////////
+
+void SPUcopy_state(u8 **io, ao_copy_func_t copy)
+{
+#define COPY(var) AO_COPY_STATE(io, copy, var)
+ COPY(regArea);
+ COPY(spuMem);
+ COPY(pSpuIrq);
+ COPY(s_chan);
+ COPY(rvb);
+ COPY(dwNoiseVal);
+ COPY(spuCtrl);
+ COPY(spuStat);
+ COPY(spuIrq);
+ COPY(spuAddr);
+ COPY(ttemp);
+ COPY(sampcount);
+ COPY(downbuf);
+ COPY(upbuf);
+ COPY(dbpos);
+ COPY(ubpos);
+ COPY(pS);
+#undef COPY
+ copy(io, pSpuBuffer, 735*4);                          // samples not yet passed to update()
+}
+
 void SPUinjectRAMImage(u16 *pIncoming)
 {
 	int i;
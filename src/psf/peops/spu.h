@@ -24,9 +24,12 @@
 //
 //*************************************************************************//
 
+#include "../ao.h"
+
 void SPUirq(void);
 
 int psf_seek(uint32_t t);
+uint32_t psf_tell(void);
 void setendless(int e);
 void setlength(int32_t stop, int32_t fade);
 
@@ -36,6 +39,7 @@ int SPUinit(void);
 int SPUopen(void);
 int SPUclose(void);
 int SPUshutdown(void);
+void SPUcopy_state(uint8_t **io, ao_copy_func_t copy);
 void SPUinjectRAMImage(uint16_t *pIncoming);
 void SPUreadDMAMem(uint32_t usPSXMem, int iSize);
 void SPUwriteDMAMem(uint32_t usPSXMem, int iSize);
@@ -337,6 +337,11 @@ int psf2_seek(u32 t)
  return(0);
 }
 
+u32 psf2_tell(void)
+{
+ return sampcount;
+}
+
 static int endless;
 void setendless2(int e)
 {
@@ -1000,6 +1005,43 @@ EXPORT_GCC void CALLBACK SPU2close(void)
  RemoveStreams();                                      // no more streaming
 }
 
+////////////////////////////////////////////////////////////////////////
+// SPU2COPYSTATE: save or restore everything that changes while playing;
+// pointers stay valid until SPU2close
+////////////////////////////////////////////////////////////////////////
+
+void SPU2copy_state(u8 **io, ao_copy_func_t copy)
+{
+#define COPY(var) AO_COPY_STATE(io, copy, var)
+ COPY(regArea);
+ COPY(spuMem);
+ COPY(pSpuIrq);
+ COPY(s_chan);
+ COPY(rvb);
+ COPY(dwNoiseVal);
+ COPY(spuCtrl2);
+ COPY(spuStat2);
+ COPY(spuIrq2);
+ COPY(spuAddr2);
+ COPY(spuRvbAddr2);
+ COPY(spuRvbAEnd2);
+ COPY(dwNewChannel2);
+ COPY(dwEndChannel2);
+ COPY(SSumR);
+ COPY(SSumL);
+ COPY(iCycle);
+ COPY(lastch);
+ COPY(iSecureStart);
+ COPY(sampcount);
+ COPY(iSpuAsyncWait);
+ COPY(sRVBPlay);
+ copy(io, sRVBStart[0], NSSIZE*2*4);
+ copy(io, sRVBStart[1], NSSIZE*2*4);
+ COPY(pS);
+#undef COPY
+ copy(io, pSpuBuffer, 735*4);                          // samples not yet passed to update()
+}
+
 #if 0
 ////////////////////////////////////////////////////////////////////////
 // SPUSHUTDOWN: called by main emu on final exit
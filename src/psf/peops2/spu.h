@@ -27,6 +27,8 @@
 //
 //*************************************************************************//
 
+#include "../ao.h"
+
 void setendless2(int e);
 void setlength2(int32_t stop, int32_t fade);
 
@@ -34,5 +36,7 @@ long SPU2init(void);
 long SPU2open(void *pDsp);
 void SPU2async(void (*update)(const void *, int));
 void SPU2close(void);
+void SPU2copy_state(uint8_t **io, ao_copy_func_t copy);
 
 int psf2_seek(uint32_t t);
+uint32_t psf2_tell(void);
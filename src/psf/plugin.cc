@@ -35,7 +35,7 @@
 #include <libaudcore/runtime.h>
 
 #include "ao.h"
-#include "corlett.h"
+#include "../plugin-common/corlett.h"
 #include "psx.h"
 
 #include "peops/spu.h"
@@ -85,13 +85,15 @@ typedef struct {
     int32_t (*stop)(void);
     int32_t (*seek)(uint32_t);
     int32_t (*execute)(void (*update)(const void *, int));
+    SnapshotCopyFunc copy_state;
+    uint32_t (*tell)(void);
 } PSFEngineFunctors;
 
 static PSFEngineFunctors psf_functor_map[ENG_COUNT] = {
-    {nullptr, nullptr, nullptr, nullptr},
-    {psf_start, psf_stop, psf_seek, psf_execute},
-    {psf2_start, psf2_stop, psf2_seek, psf2_execute},
-    {spx_start, spx_stop, psf_seek, spx_execute},
+    {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
+    {psf_start, psf_stop, psf_seek, psf_execute, psf_copy_state, psf_tell},
+    {psf2_start, psf2_stop, psf2_seek, psf2_execute, psf2_copy_state, psf2_tell},
+    {spx_start, spx_stop, psf_seek, spx_execute, spx_copy_state, psf_tell},
 };
 
 const char* const PSFPlugin::defaults[] =
@@ -112,9 +114,10 @@ static String dirpath;
 bool stop_flag = false;
 
 /* The emulation engine can only seek forward, not back.  This variable is set
- * a non-negative time (milliseconds) when the song is to be restarted in order
- * to seek backward. */
-static int reverse_seek;
+ * a non-negative time (milliseconds) when the engine is to be stopped in order
+ * to seek backward, or forward to a part of the song played before.  Playback
+ * then resumes from a snapshot, or restarts if there is none. */
+static int pending_seek;
 
 static PSFEngine psf_probe(const char *buf, int len)
 {
@@ -137,20 +140,15 @@ static PSFEngine psf_probe(const char *buf, int len)
 }
 
 /* ao_get_lib: called to load secondary files */
-Index<char> ao_get_lib(char *filename)
+Index<char> ao_get_lib(char *filename, Index<char> *program)
 {
-    VFSFile file(filename_build({dirpath, filename}), "r");
-    return file ? file.read_all() : Index<char>();
+    return corlett_get_lib(filename_build({dirpath, filename}), program);
 }
 
 bool PSFPlugin::read_tag(const char *filename, VFSFile &file, Tuple &tuple, Index<char> *image)
 {
-    Index<char> buf = file.read_all ();
-    if (!buf.len())
-        return false;
-
     corlett_t *c;
-    if (corlett_decode((uint8_t *)buf.begin(), buf.len(), nullptr, nullptr, &c) != AO_SUCCESS)
+    if (corlett_read_tags(file, &c) != AO_SUCCESS)
         return false;
 
     tuple.set_int(Tuple::Length, psfTimeToMS(c->inf_length) + psfTimeToMS(c->inf_fade));
@@ -198,32 +196,48 @@ bool PSFPlugin::play(const char *filename, VFSFile &file)
     set_stream_bitrate(44100*2*2*8);
     open_audio(FMT_S16_NE, 44100, 2);
 
-    reverse_seek = -1;
+    pending_seek = -1;
 
-    /* This loop will restart playback from the beginning when necessary to seek
-     * backwards in the file (reverse_seek >= 0). */
-    do
+    if (f->start((uint8_t *)buf.begin(), buf.len()) != AO_SUCCESS)
     {
-        if (f->start((uint8_t *)buf.begin(), buf.len()) != AO_SUCCESS)
-        {
-            error = true;
-            goto cleanup;
-        }
+        error = true;
+        goto cleanup;
+    }
 
-        if (reverse_seek >= 0)
-        {
-            f->seek(reverse_seek); /* should never fail here */
-            reverse_seek = -1;
-        }
+    snapshot_init(f->copy_state, f->tell);
 
+    /* This loop will resume from a snapshot, or restart playback from the
+     * beginning, when necessary to seek (pending_seek >= 0). */
+    while (true)
+    {
         stop_flag = false;
 
         f->execute(update);
-        f->stop();
+
+        if (pending_seek < 0)
+            break;
+
+        if (!snapshot_restore(pending_seek))
+        {
+            f->stop();
+
+            if (f->start((uint8_t *)buf.begin(), buf.len()) != AO_SUCCESS)
+            {
+                error = true;
+                goto cleanup;
+            }
+
+            snapshot_init(f->copy_state, f->tell);
+        }
+
+        f->seek(pending_seek); /* should never fail here */
+        pending_seek = -1;
     }
-    while (reverse_seek >= 0);
+
+    f->stop();
 
 cleanup:
+    snapshot_free();
     f = nullptr;
     dirpath = String ();
 
@@ -238,13 +252,17 @@ void PSFPlugin::update(const void *data, int bytes)
         return;
     }
 
+    /* the rest of the frame is from before the seek */
+    if (pending_seek >= 0)
+        return;
+
     int seek = check_seek();
 
     if (seek >= 0)
     {
-        if (!f->seek(seek))
+        if (snapshot_can_seek(seek) || !f->seek(seek))
         {
-            reverse_seek = seek;
+            pending_seek = seek;
             stop_flag = true;
         }
 
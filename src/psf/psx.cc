@@ -15,10 +15,13 @@
 
 #include <stdio.h>
 #include <stdarg.h>
+#include <string.h>
 #include "ao.h"
 #include "cpuintrf.h"
 #include "psx.h"
 
+#define LE32(x) FROM_LE32(x)
+
 #define EXC_INT ( 0 )
 #define EXC_ADEL ( 4 )
 #define EXC_ADES ( 5 )
@@ -167,6 +170,17 @@ static mips_cpu_context mipscpu;
 
 static int mips_ICount = 0;
 
+// idle loop detection, see mips_check_idle()
+#define MIPS_IDLE_MAX_INSNS ( 8 )
+
+static uint32_t mips_idle_pc = 1;
+static int mips_idle_ok;
+static int mips_idle_icount;
+static uint32_t mips_idle_io_count;
+static uint32_t mips_idle_hi, mips_idle_lo;
+static uint32_t mips_idle_r[ 32 ];
+static uint32_t mips_idle_cp0r[ 32 ];
+
 static uint32_t mips_mtc0_writemask[]=
 {
 	0xffffffff, /* INDEX */
@@ -284,11 +298,107 @@ static inline void mips_set_pc( unsigned val )
 	mipscpu.delayv = 0;
 }
 
+// true if the code from start to end only computes on registers, reads memory
+// and branches, so that running it again with the same registers and memory
+// gives the same result
+static int mips_idle_safe( uint32_t start, uint32_t end )
+{
+	uint32_t pc, op;
+
+	if( ( start & 0x7f800000 ) != 0 || ( end & 0x7f800000 ) != 0 )
+	{
+		return 0;
+	}
+
+	for( pc = start; pc <= end; pc += 4 )
+	{
+		op = LE32( psx_ram[ ( pc & 0x1fffff ) >> 2 ] );
+
+		switch( INS_OP( op ) )
+		{
+		case OP_SPECIAL:
+			switch( INS_FUNCT( op ) )
+			{
+			case FUNCT_SLL: case FUNCT_SRL: case FUNCT_SRA:
+			case FUNCT_SLLV: case FUNCT_SRLV: case FUNCT_SRAV:
+			case FUNCT_JR: case FUNCT_ADDU: case FUNCT_SUBU:
+			case FUNCT_AND: case FUNCT_OR: case FUNCT_XOR: case FUNCT_NOR:
+			case FUNCT_SLT: case FUNCT_SLTU:
+				break;
+			default:
+				return 0;
+			}
+			break;
+		case OP_REGIMM:
+			if( INS_RT( op ) != RT_BLTZ && INS_RT( op ) != RT_BGEZ )
+			{
+				return 0;
+			}
+			break;
+		case OP_J: case OP_BEQ: case OP_BNE: case OP_BLEZ: case OP_BGTZ:
+		case OP_ADDIU: case OP_SLTI: case OP_SLTIU:
+		case OP_ANDI: case OP_ORI: case OP_XORI: case OP_LUI:
+		case OP_LB: case OP_LH: case OP_LW: case OP_LBU: case OP_LHU:
+			break;
+		default:
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+// Called for each taken backward branch.  Drivers often spin in a short loop
+// polling RAM for an interrupt handler to change it, but interrupts, timers
+// and DMA completion are all raised between slices.  So once such a loop has
+// gone around with no I/O and the same registers at the top, it can only keep
+// spinning until the slice ends, and the CPU might as well stop right here.
+static void mips_check_idle( uint32_t target )
+{
+	uint32_t end = mipscpu.pc;	// the delay slot
+	int insns = ( end - target ) / 4 + 1;
+
+	if( target == mips_idle_pc && mips_idle_ok &&
+		mips_idle_icount - mips_ICount == insns &&	// took the straight path
+		mips_idle_io_count == psx_hw_io_count &&
+		mips_idle_hi == mipscpu.hi && mips_idle_lo == mipscpu.lo &&
+		!memcmp( mips_idle_r, mipscpu.r, sizeof mips_idle_r ) &&
+		!memcmp( mips_idle_cp0r, mipscpu.cp0r, sizeof mips_idle_cp0r ) )
+	{
+		mips_ICount = 0;
+		return;
+	}
+
+	if( target != mips_idle_pc )
+	{
+		mips_idle_pc = target;
+		mips_idle_ok = mips_idle_safe( target, end );
+	}
+
+	mips_idle_icount = mips_ICount;
+	mips_idle_io_count = psx_hw_io_count;
+	mips_idle_hi = mipscpu.hi;
+	mips_idle_lo = mipscpu.lo;
+	memcpy( mips_idle_r, mipscpu.r, sizeof mips_idle_r );
+	memcpy( mips_idle_cp0r, mipscpu.cp0r, sizeof mips_idle_cp0r );
+}
+
+// called at the end of a delay slot, when the branch is about to be taken
+static inline void mips_take_branch( void )
+{
+	if( mipscpu.delayv <= mipscpu.pc && mipscpu.pc - mipscpu.delayv < MIPS_IDLE_MAX_INSNS * 4 )
+	{
+		mips_check_idle( mipscpu.delayv );
+	}
+
+	mips_set_pc( mipscpu.delayv );
+}
+
 static inline void mips_advance_pc( void )
 {
 	if( mipscpu.delayr == REGPC )
 	{
-		mips_set_pc( mipscpu.delayv );
+		mips_take_branch();
 	}
 	else
 	{
@@ -310,7 +420,7 @@ static inline void mips_delayed_load( uint32_t n_r, uint32_t n_v )
 {
 	if( mipscpu.delayr == REGPC )
 	{
-		mips_set_pc( mipscpu.delayv );
+		mips_take_branch();
 		mipscpu.delayr = n_r;
 		mipscpu.delayv = n_v;
 	}
@@ -389,18 +499,40 @@ void psx_hw_runcounters(void);
 
 int psxcpu_verbose = 0;
 
+// code runs from main RAM (or one of its KUSEG/KSEG0 mirrors) nearly all the
+// time, so fetch straight from it instead of through the full bus decode
+static inline uint32_t mips_fetch( uint32_t pc )
+{
+	if( ( pc & 0x7f800000 ) == 0 )
+	{
+		return LE32( psx_ram[ ( pc & 0x1fffff ) >> 2 ] );
+	}
+
+	return cpu_readop32( pc );
+}
+
+// SPECIAL instructions are dispatched on their function code straight away
+#define SPECIAL( funct ) ( 64 + ( funct ) )
+
+static inline uint32_t mips_dispatch( uint32_t op )
+{
+	return INS_OP( op ) != OP_SPECIAL ? INS_OP( op ) : SPECIAL( INS_FUNCT( op ) );
+}
+
 int mips_execute( int cycles )
 {
 	uint32_t n_res;
 
 	mips_ICount = cycles;
+	mips_idle_pc = 1;	// the machine may have changed since the last slice
+
 	do
 	{
 //		CALL_MAME_DEBUG;
 
 //		psx_hw_runcounters();
 
-		mipscpu.op = cpu_readop32( mipscpu.pc );
+		mipscpu.op = mips_fetch( mipscpu.pc );
 
 #if 0
 		while (mipscpu.prevpc == mipscpu.pc)
@@ -425,181 +557,163 @@ int mips_execute( int cycles )
 //			psxcpu_verbose--;
 		}
 #endif
-		switch( INS_OP( mipscpu.op ) )
+		switch( mips_dispatch( mipscpu.op ) )
 		{
-		case OP_SPECIAL:
-			switch( INS_FUNCT( mipscpu.op ) )
+		case SPECIAL( FUNCT_HLECALL ):
+//			printf("HLECALL, PC = %08x\n", mipscpu.pc);
+			psx_bios_hle(mipscpu.pc);
+			break;
+		case SPECIAL( FUNCT_SLL ):
+			mips_load( INS_RD( mipscpu.op ), mipscpu.r[ INS_RT( mipscpu.op ) ] << INS_SHAMT( mipscpu.op ) );
+			break;
+		case SPECIAL( FUNCT_SRL ):
+			mips_load( INS_RD( mipscpu.op ), mipscpu.r[ INS_RT( mipscpu.op ) ] >> INS_SHAMT( mipscpu.op ) );
+			break;
+		case SPECIAL( FUNCT_SRA ):
+			mips_load( INS_RD( mipscpu.op ), (int32_t)mipscpu.r[ INS_RT( mipscpu.op ) ] >> INS_SHAMT( mipscpu.op ) );
+			break;
+		case SPECIAL( FUNCT_SLLV ):
+			mips_load( INS_RD( mipscpu.op ), mipscpu.r[ INS_RT( mipscpu.op ) ] << ( mipscpu.r[ INS_RS( mipscpu.op ) ] & 31 ) );
+			break;
+		case SPECIAL( FUNCT_SRLV ):
+			mips_load( INS_RD( mipscpu.op ), mipscpu.r[ INS_RT( mipscpu.op ) ] >> ( mipscpu.r[ INS_RS( mipscpu.op ) ] & 31 ) );
+			break;
+		case SPECIAL( FUNCT_SRAV ):
+			mips_load( INS_RD( mipscpu.op ), (int32_t)mipscpu.r[ INS_RT( mipscpu.op ) ] >> ( mipscpu.r[ INS_RS( mipscpu.op ) ] & 31 ) );
+			break;
+		case SPECIAL( FUNCT_JR ):
+			if( INS_RD( mipscpu.op ) != 0 )
+			{
+				mips_exception( EXC_RI );
+			}
+			else
 			{
-			case FUNCT_HLECALL:
-//				printf("HLECALL, PC = %08x\n", mipscpu.pc);
-				psx_bios_hle(mipscpu.pc);
-				break;
-			case FUNCT_SLL:
-				mips_load( INS_RD( mipscpu.op ), mipscpu.r[ INS_RT( mipscpu.op ) ] << INS_SHAMT( mipscpu.op ) );
-				break;
-			case FUNCT_SRL:
-				mips_load( INS_RD( mipscpu.op ), mipscpu.r[ INS_RT( mipscpu.op ) ] >> INS_SHAMT( mipscpu.op ) );
-				break;
-			case FUNCT_SRA:
-				mips_load( INS_RD( mipscpu.op ), (int32_t)mipscpu.r[ INS_RT( mipscpu.op ) ] >> INS_SHAMT( mipscpu.op ) );
-				break;
-			case FUNCT_SLLV:
-				mips_load( INS_RD( mipscpu.op ), mipscpu.r[ INS_RT( mipscpu.op ) ] << ( mipscpu.r[ INS_RS( mipscpu.op ) ] & 31 ) );
-				break;
-			case FUNCT_SRLV:
-				mips_load( INS_RD( mipscpu.op ), mipscpu.r[ INS_RT( mipscpu.op ) ] >> ( mipscpu.r[ INS_RS( mipscpu.op ) ] & 31 ) );
-				break;
-			case FUNCT_SRAV:
-				mips_load( INS_RD( mipscpu.op ), (int32_t)mipscpu.r[ INS_RT( mipscpu.op ) ] >> ( mipscpu.r[ INS_RS( mipscpu.op ) ] & 31 ) );
-				break;
-			case FUNCT_JR:
-				if( INS_RD( mipscpu.op ) != 0 )
-				{
-					mips_exception( EXC_RI );
-				}
-				else
-				{
-					mips_delayed_branch( mipscpu.r[ INS_RS( mipscpu.op ) ] );
-				}
-				break;
-			case FUNCT_JALR:
-				n_res = mipscpu.pc + 8;
 				mips_delayed_branch( mipscpu.r[ INS_RS( mipscpu.op ) ] );
-				if( INS_RD( mipscpu.op ) != 0 )
-				{
-					mipscpu.r[ INS_RD( mipscpu.op ) ] = n_res;
-				}
-				break;
-			case FUNCT_SYSCALL:
-				mips_exception( EXC_SYS );
-				break;
-			case FUNCT_BREAK:
-				printf("BREAK!\n");
-				exit(-1);
-//				mips_exception( EXC_BP );
+			}
+			break;
+		case SPECIAL( FUNCT_JALR ):
+			n_res = mipscpu.pc + 8;
+			mips_delayed_branch( mipscpu.r[ INS_RS( mipscpu.op ) ] );
+			if( INS_RD( mipscpu.op ) != 0 )
+			{
+				mipscpu.r[ INS_RD( mipscpu.op ) ] = n_res;
+			}
+			break;
+		case SPECIAL( FUNCT_SYSCALL ):
+			mips_exception( EXC_SYS );
+			break;
+		case SPECIAL( FUNCT_BREAK ):
+			printf("BREAK!\n");
+			exit(-1);
+//			mips_exception( EXC_BP );
+			mips_advance_pc();
+			break;
+		case SPECIAL( FUNCT_MFHI ):
+			mips_load( INS_RD( mipscpu.op ), mipscpu.hi );
+			break;
+		case SPECIAL( FUNCT_MTHI ):
+			if( INS_RD( mipscpu.op ) != 0 )
+			{
+				mips_exception( EXC_RI );
+			}
+			else
+			{
 				mips_advance_pc();
-				break;
-			case FUNCT_MFHI:
-				mips_load( INS_RD( mipscpu.op ), mipscpu.hi );
-				break;
-			case FUNCT_MTHI:
-				if( INS_RD( mipscpu.op ) != 0 )
-				{
-					mips_exception( EXC_RI );
-				}
-				else
+				mipscpu.hi = mipscpu.r[ INS_RS( mipscpu.op ) ];
+			}
+			break;
+		case SPECIAL( FUNCT_MFLO ):
+			mips_load( INS_RD( mipscpu.op ),  mipscpu.lo );
+			break;
+		case SPECIAL( FUNCT_MTLO ):
+			if( INS_RD( mipscpu.op ) != 0 )
+			{
+				mips_exception( EXC_RI );
+			}
+			else
+			{
+				mips_advance_pc();
+				mipscpu.lo = mipscpu.r[ INS_RS( mipscpu.op ) ];
+			}
+			break;
+		case SPECIAL( FUNCT_MULT ):
+			if( INS_RD( mipscpu.op ) != 0 )
+			{
+				mips_exception( EXC_RI );
+			}
+			else
+			{
+				int64_t n_res64;
+				n_res64 = MUL_64_32_32( (int32_t)mipscpu.r[ INS_RS( mipscpu.op ) ], (int32_t)mipscpu.r[ INS_RT( mipscpu.op ) ] );
+				mips_advance_pc();
+				mipscpu.lo = LO32_32_64( n_res64 );
+				mipscpu.hi = HI32_32_64( n_res64 );
+			}
+			break;
+		case SPECIAL( FUNCT_MULTU ):
+			if( INS_RD( mipscpu.op ) != 0 )
+			{
+				mips_exception( EXC_RI );
+			}
+			else
+			{
+				uint64_t n_res64;
+				n_res64 = MUL_U64_U32_U32( mipscpu.r[ INS_RS( mipscpu.op ) ], mipscpu.r[ INS_RT( mipscpu.op ) ] );
+				mips_advance_pc();
+				mipscpu.lo = LO32_U32_U64( n_res64 );
+				mipscpu.hi = HI32_U32_U64( n_res64 );
+			}
+			break;
+		case SPECIAL( FUNCT_DIV ):
+			if( INS_RD( mipscpu.op ) != 0 )
+			{
+				mips_exception( EXC_RI );
+			}
+			else
+			{
+				uint32_t n_div;
+				uint32_t n_mod;
+				if( mipscpu.r[ INS_RT( mipscpu.op ) ] != 0 )
 				{
+					n_div = (int32_t)mipscpu.r[ INS_RS( mipscpu.op ) ] / (int32_t)mipscpu.r[ INS_RT( mipscpu.op ) ];
+					n_mod = (int32_t)mipscpu.r[ INS_RS( mipscpu.op ) ] % (int32_t)mipscpu.r[ INS_RT( mipscpu.op ) ];
 					mips_advance_pc();
-					mipscpu.hi = mipscpu.r[ INS_RS( mipscpu.op ) ];
-				}
-				break;
-			case FUNCT_MFLO:
-				mips_load( INS_RD( mipscpu.op ),  mipscpu.lo );
-				break;
-			case FUNCT_MTLO:
-				if( INS_RD( mipscpu.op ) != 0 )
-				{
-					mips_exception( EXC_RI );
+					mipscpu.lo = n_div;
+					mipscpu.hi = n_mod;
 				}
 				else
 				{
 					mips_advance_pc();
-					mipscpu.lo = mipscpu.r[ INS_RS( mipscpu.op ) ];
-				}
-				break;
-			case FUNCT_MULT:
-				if( INS_RD( mipscpu.op ) != 0 )
-				{
-					mips_exception( EXC_RI );
 				}
-				else
+			}
+			break;
+		case SPECIAL( FUNCT_DIVU ):
+			if( INS_RD( mipscpu.op ) != 0 )
+			{
+				mips_exception( EXC_RI );
+			}
+			else
+			{
+				uint32_t n_div;
+				uint32_t n_mod;
+				if( mipscpu.r[ INS_RT( mipscpu.op ) ] != 0 )
 				{
-					int64_t n_res64;
-					n_res64 = MUL_64_32_32( (int32_t)mipscpu.r[ INS_RS( mipscpu.op ) ], (int32_t)mipscpu.r[ INS_RT( mipscpu.op ) ] );
+					n_div = mipscpu.r[ INS_RS( mipscpu.op ) ] / mipscpu.r[ INS_RT( mipscpu.op ) ];
+					n_mod = mipscpu.r[ INS_RS( mipscpu.op ) ] % mipscpu.r[ INS_RT( mipscpu.op ) ];
 					mips_advance_pc();
-					mipscpu.lo = LO32_32_64( n_res64 );
-					mipscpu.hi = HI32_32_64( n_res64 );
-				}
-				break;
-			case FUNCT_MULTU:
-				if( INS_RD( mipscpu.op ) != 0 )
-				{
-					mips_exception( EXC_RI );
+					mipscpu.lo = n_div;
+					mipscpu.hi = n_mod;
 				}
 				else
 				{
-					uint64_t n_res64;
-					n_res64 = MUL_U64_U32_U32( mipscpu.r[ INS_RS( mipscpu.op ) ], mipscpu.r[ INS_RT( mipscpu.op ) ] );
 					mips_advance_pc();
-					mipscpu.lo = LO32_U32_U64( n_res64 );
-					mipscpu.hi = HI32_U32_U64( n_res64 );
-				}
-				break;
-			case FUNCT_DIV:
-				if( INS_RD( mipscpu.op ) != 0 )
-				{
-					mips_exception( EXC_RI );
-				}
-				else
-				{
-					uint32_t n_div;
-					uint32_t n_mod;
-					if( mipscpu.r[ INS_RT( mipscpu.op ) ] != 0 )
-					{
-						n_div = (int32_t)mipscpu.r[ INS_RS( mipscpu.op ) ] / (int32_t)mipscpu.r[ INS_RT( mipscpu.op ) ];
-						n_mod = (int32_t)mipscpu.r[ INS_RS( mipscpu.op ) ] % (int32_t)mipscpu.r[ INS_RT( mipscpu.op ) ];
-						mips_advance_pc();
-						mipscpu.lo = n_div;
-						mipscpu.hi = n_mod;
-					}
-					else
-					{
-						mips_advance_pc();
-					}
 				}
-				break;
-			case FUNCT_DIVU:
-				if( INS_RD( mipscpu.op ) != 0 )
-				{
-					mips_exception( EXC_RI );
-				}
-				else
-				{
-					uint32_t n_div;
-					uint32_t n_mod;
-					if( mipscpu.r[ INS_RT( mipscpu.op ) ] != 0 )
-					{
-						n_div = mipscpu.r[ INS_RS( mipscpu.op ) ] / mipscpu.r[ INS_RT( mipscpu.op ) ];
-						n_mod = mipscpu.r[ INS_RS( mipscpu.op ) ] % mipscpu.r[ INS_RT( mipscpu.op ) ];
-						mips_advance_pc();
-						mipscpu.lo = n_div;
-						mipscpu.hi = n_mod;
-					}
-					else
-					{
-						mips_advance_pc();
-					}
-				}
-				break;
-			case FUNCT_ADD:
-				{
-					n_res = mipscpu.r[ INS_RS( mipscpu.op ) ] + mipscpu.r[ INS_RT( mipscpu.op ) ];
-					if( (int32_t)( ~( mipscpu.r[ INS_RS( mipscpu.op ) ] ^ mipscpu.r[ INS_RT( mipscpu.op ) ] ) & ( mipscpu.r[ INS_RS( mipscpu.op ) ] ^ n_res ) ) < 0 )
-					{
-						mips_exception( EXC_OVF );
-					}
-					else
-					{
-						mips_load( INS_RD( mipscpu.op ), n_res );
-					}
-				}
-				break;
-			case FUNCT_ADDU:
-				mips_load( INS_RD( mipscpu.op ), mipscpu.r[ INS_RS( mipscpu.op ) ] + mipscpu.r[ INS_RT( mipscpu.op ) ] );
-				break;
-			case FUNCT_SUB:
-				n_res = mipscpu.r[ INS_RS( mipscpu.op ) ] - mipscpu.r[ INS_RT( mipscpu.op ) ];
-				if( (int32_t)( ( mipscpu.r[ INS_RS( mipscpu.op ) ] ^ mipscpu.r[ INS_RT( mipscpu.op ) ] ) & ( mipscpu.r[ INS_RS( mipscpu.op ) ] ^ n_res ) ) < 0 )
+			}
+			break;
+		case SPECIAL( FUNCT_ADD ):
+			{
+				n_res = mipscpu.r[ INS_RS( mipscpu.op ) ] + mipscpu.r[ INS_RT( mipscpu.op ) ];
+				if( (int32_t)( ~( mipscpu.r[ INS_RS( mipscpu.op ) ] ^ mipscpu.r[ INS_RT( mipscpu.op ) ] ) & ( mipscpu.r[ INS_RS( mipscpu.op ) ] ^ n_res ) ) < 0 )
 				{
 					mips_exception( EXC_OVF );
 				}
@@ -607,33 +721,43 @@ int mips_execute( int cycles )
 				{
 					mips_load( INS_RD( mipscpu.op ), n_res );
 				}
-				break;
-			case FUNCT_SUBU:
-				mips_load( INS_RD( mipscpu.op ), mipscpu.r[ INS_RS( mipscpu.op ) ] - mipscpu.r[ INS_RT( mipscpu.op ) ] );
-				break;
-			case FUNCT_AND:
-				mips_load( INS_RD( mipscpu.op ), mipscpu.r[ INS_RS( mipscpu.op ) ] & mipscpu.r[ INS_RT( mipscpu.op ) ] );
-				break;
-			case FUNCT_OR:
-				mips_load( INS_RD( mipscpu.op ), mipscpu.r[ INS_RS( mipscpu.op ) ] | mipscpu.r[ INS_RT( mipscpu.op ) ] );
-				break;
-			case FUNCT_XOR:
-				mips_load( INS_RD( mipscpu.op ), mipscpu.r[ INS_RS( mipscpu.op ) ] ^ mipscpu.r[ INS_RT( mipscpu.op ) ] );
-				break;
-			case FUNCT_NOR:
-				mips_load( INS_RD( mipscpu.op ), ~( mipscpu.r[ INS_RS( mipscpu.op ) ] | mipscpu.r[ INS_RT( mipscpu.op ) ] ) );
-				break;
-			case FUNCT_SLT:
-				mips_load( INS_RD( mipscpu.op ), (int32_t)mipscpu.r[ INS_RS( mipscpu.op ) ] < (int32_t)mipscpu.r[ INS_RT( mipscpu.op ) ] );
-				break;
-			case FUNCT_SLTU:
-				mips_load( INS_RD( mipscpu.op ), mipscpu.r[ INS_RS( mipscpu.op ) ] < mipscpu.r[ INS_RT( mipscpu.op ) ] );
-				break;
-			default:
-				mips_exception( EXC_RI );
-				break;
 			}
 			break;
+		case SPECIAL( FUNCT_ADDU ):
+			mips_load( INS_RD( mipscpu.op ), mipscpu.r[ INS_RS( mipscpu.op ) ] + mipscpu.r[ INS_RT( mipscpu.op ) ] );
+			break;
+		case SPECIAL( FUNCT_SUB ):
+			n_res = mipscpu.r[ INS_RS( mipscpu.op ) ] - mipscpu.r[ INS_RT( mipscpu.op ) ];
+			if( (int32_t)( ( mipscpu.r[ INS_RS( mipscpu.op ) ] ^ mipscpu.r[ INS_RT( mipscpu.op ) ] ) & ( mipscpu.r[ INS_RS( mipscpu.op ) ] ^ n_res ) ) < 0 )
+			{
+				mips_exception( EXC_OVF );
+			}
+			else
+			{
+				mips_load( INS_RD( mipscpu.op ), n_res );
+			}
+			break;
+		case SPECIAL( FUNCT_SUBU ):
+			mips_load( INS_RD( mipscpu.op ), mipscpu.r[ INS_RS( mipscpu.op ) ] - mipscpu.r[ INS_RT( mipscpu.op ) ] );
+			break;
+		case SPECIAL( FUNCT_AND ):
+			mips_load( INS_RD( mipscpu.op ), mipscpu.r[ INS_RS( mipscpu.op ) ] & mipscpu.r[ INS_RT( mipscpu.op ) ] );
+			break;
+		case SPECIAL( FUNCT_OR ):
+			mips_load( INS_RD( mipscpu.op ), mipscpu.r[ INS_RS( mipscpu.op ) ] | mipscpu.r[ INS_RT( mipscpu.op ) ] );
+			break;
+		case SPECIAL( FUNCT_XOR ):
+			mips_load( INS_RD( mipscpu.op ), mipscpu.r[ INS_RS( mipscpu.op ) ] ^ mipscpu.r[ INS_RT( mipscpu.op ) ] );
+			break;
+		case SPECIAL( FUNCT_NOR ):
+			mips_load( INS_RD( mipscpu.op ), ~( mipscpu.r[ INS_RS( mipscpu.op ) ] | mipscpu.r[ INS_RT( mipscpu.op ) ] ) );
+			break;
+		case SPECIAL( FUNCT_SLT ):
+			mips_load( INS_RD( mipscpu.op ), (int32_t)mipscpu.r[ INS_RS( mipscpu.op ) ] < (int32_t)mipscpu.r[ INS_RT( mipscpu.op ) ] );
+			break;
+		case SPECIAL( FUNCT_SLTU ):
+			mips_load( INS_RD( mipscpu.op ), mipscpu.r[ INS_RS( mipscpu.op ) ] < mipscpu.r[ INS_RT( mipscpu.op ) ] );
+			break;
 		case OP_REGIMM:
 			switch( INS_RT( mipscpu.op ) )
 			{
@@ -1633,6 +1757,12 @@ int mips_execute( int cycles )
 			}
 			break;
 		default:
+			// reserved SPECIAL function codes
+			if( INS_OP( mipscpu.op ) == OP_SPECIAL )
+			{
+				mips_exception( EXC_RI );
+				break;
+			}
 			printf( "%08x: unknown opcode %08x (prev %08x, RA %08x)\n", mipscpu.pc, mipscpu.op, mipscpu.prevpc,  mipscpu.r[31] );
 			mips_stop();
 			mips_exception( EXC_RI );
@@ -2975,6 +3105,12 @@ void mips_set_icount(int count)
 	mips_ICount = count;
 }
 
+void mips_copy_state(uint8_t **io, ao_copy_func_t copy)
+{
+	AO_COPY_STATE(io, copy, mipscpu);
+	AO_COPY_STATE(io, copy, mips_ICount);
+}
+
 
 #if (HAS_PSXCPU)
 /**************************************************************************
@@ -291,6 +291,7 @@ extern int psf_refresh;
 int32_t psf_start(uint8_t *buffer, uint32_t length);
 int32_t psf_execute(void (*update)(const void *, int));
 int32_t psf_stop(void);
+void psf_copy_state(uint8_t **io, ao_copy_func_t copy);
 
 /* eng_psf2.cc */
 uint32_t psf2_load_elf(uint8_t *start, uint32_t len);
@@ -298,6 +299,7 @@ uint32_t psf2_load_file(const char *file, uint8_t *buf, uint32_t buflen);
 int32_t psf2_start(uint8_t *, uint32_t length);
 int32_t psf2_execute(void (*update)(const void *, int));
 int32_t psf2_stop(void);
+void psf2_copy_state(uint8_t **io, ao_copy_func_t copy);
 int32_t psf2_command(int32_t, int32_t);
 uint32_t psf2_get_loadaddr(void);
 void psf2_set_loadaddr(uint32_t addr);
@@ -306,10 +308,20 @@ void psf2_set_loadaddr(uint32_t addr);
 int32_t spx_start(uint8_t *buffer, uint32_t length);
 int32_t spx_execute(void (*update)(const void *, int));
 int32_t spx_stop(void);
+void spx_copy_state(uint8_t **io, ao_copy_func_t copy);
 
 /* plugin.cc */
 extern bool stop_flag;
 
+/* snapshot.cc; the engines call snapshot_frame() between frames */
+typedef void (*SnapshotCopyFunc)(uint8_t **io, ao_copy_func_t copy);
+
+void snapshot_init(SnapshotCopyFunc copy_state, uint32_t (*tell)(void));
+void snapshot_free(void);
+void snapshot_frame(void);
+bool snapshot_can_seek(int ms);
+bool snapshot_restore(int ms);
+
 /* psx.cc */
 void mips_init(void);
 void mips_reset(void *param);
@@ -323,12 +335,14 @@ void mips_set_status(uint32_t status);
 uint32_t mips_get_ePC(void);
 int mips_get_icount(void);
 void mips_set_icount(int count);
+void mips_copy_state(uint8_t **io, ao_copy_func_t copy);
 
 /* psx_hw.cc */
 extern uint32_t psx_ram[((2*1024*1024)/4)+4];
 extern uint32_t psx_scratch[0x400];
 extern uint32_t initial_ram[((2*1024*1024)/4)+4];
 extern uint32_t initial_scratch[0x400];
+extern uint32_t psx_hw_io_count;
 
 void psx_hw_slice(void);
 void ps2_hw_slice(void);
@@ -336,6 +350,7 @@ void psx_hw_frame(void);
 void ps2_hw_frame(void);
 
 void psx_hw_init(void);
+void psx_hw_copy_state(uint8_t **io, ao_copy_func_t copy);
 void psx_bios_hle(uint32_t pc);
 void psx_hw_runcounters(void);
 
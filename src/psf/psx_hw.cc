@@ -219,6 +219,10 @@ uint32_t psx_scratch[0x400];
 uint32_t initial_ram[(2*1024*1024)/4+4];
 uint32_t initial_scratch[0x400];
 
+// bumped on every write and every read of anything but main RAM; the CPU
+// core uses it to tell whether a loop can have any effect on the machine
+uint32_t psx_hw_io_count;
+
 static uint32_t spu_delay, dma_icr, irq_data, irq_mask, dma_timer, WAI;
 static uint32_t dma4_madr, dma4_bcr, dma4_chcr, dma4_delay;
 static uint32_t dma7_madr, dma7_bcr, dma7_chcr, dma7_delay;
@@ -468,6 +472,8 @@ static uint32_t psx_hw_read(offs_t offset, uint32_t mem_mask)
 		return LE32(psx_ram[offset>>2]);
 	}
 
+	psx_hw_io_count++;
+
 	if (offset == 0xbfc00180 || offset == 0xbfc00184)	// exception vector
 	{
 		return FUNCT_HLECALL;
@@ -651,6 +657,8 @@ static void psx_hw_write(offs_t offset, uint32_t data, uint32_t mem_mask)
 {
 	union cpuinfo mipsinfo;
 
+	psx_hw_io_count++;
+
 	if (offset <= 0x007fffff)
 	{
 		offset &= 0x1fffff;
@@ -1313,6 +1321,73 @@ void psx_hw_init(void)
 	root_cnts[3].interrupt = 1;
 }
 
+// everything psx_hw_init() sets up, plus RAM; the pointers stay valid as long
+// as the song isn't restarted
+void psx_hw_copy_state(uint8_t **io, ao_copy_func_t copy)
+{
+	#define COPY(var) AO_COPY_STATE(io, copy, var)
+
+	COPY(psx_ram);
+	COPY(psx_scratch);
+
+	COPY(softcall_target);
+	COPY(filestat);
+	COPY(filedata);
+	COPY(filesize);
+	COPY(filepos);
+	COPY(intr_susp);
+	COPY(sys_time);
+	COPY(timerexp);
+
+	COPY(iNumLibs);
+	COPY(reglibs);
+	COPY(iNumFlags);
+	COPY(evflags);
+	COPY(iNumSema);
+	COPY(semaphores);
+	COPY(iNumThreads);
+	COPY(iCurThread);
+	COPY(threads);
+	COPY(iop_timers);
+	COPY(iNumTimers);
+	COPY(root_cnts);
+	COPY(Event);
+	COPY(CounterEvent);
+
+	COPY(spu_delay);
+	COPY(dma_icr);
+	COPY(irq_data);
+	COPY(irq_mask);
+	COPY(dma_timer);
+	COPY(WAI);
+	COPY(dma4_madr);
+	COPY(dma4_bcr);
+	COPY(dma4_chcr);
+	COPY(dma4_delay);
+	COPY(dma7_madr);
+	COPY(dma7_bcr);
+	COPY(dma7_chcr);
+	COPY(dma7_delay);
+	COPY(dma4_cb);
+	COPY(dma7_cb);
+	COPY(dma4_fval);
+	COPY(dma4_flag);
+	COPY(dma7_fval);
+	COPY(dma7_flag);
+	COPY(irq9_cb);
+	COPY(irq9_fval);
+	COPY(irq9_flag);
+
+	COPY(gpu_stat);
+	COPY(fcnt);
+	COPY(heap_addr);
+	COPY(entry_int);
+	COPY(irq_regs);
+	COPY(irq_mutex);
+
+	#undef COPY
+}
+
 void psx_bios_hle(uint32_t pc)
 {
 	uint32_t subcall, status;
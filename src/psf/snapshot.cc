@@ -0,0 +1,169 @@
+/*
+ * Audacious: Cross platform multimedia player
+ * Copyright (c) 2026 Audacious Team
+ *
+ * Periodic snapshots of the PSF/PSF2/SPX emulation, so that seeking backward
+ * can resume from the closest one instead of restarting the song.
+ */
+
+#include <string.h>
+#include <utility>
+
+#include <libaudcore/index.h>
+
+#include "ao.h"
+#include "psx.h"
+
+/* PSF2 state is a bit over 4 MB (IOP RAM plus SPU2 RAM), PSF just under 3 MB */
+#define MAX_SNAPSHOTS   32
+#define MEMORY_LIMIT    (64 * 1024 * 1024)
+
+/* initial samples between snapshots; doubles each time the pool fills up */
+#define INITIAL_INTERVAL    (AUDIO_RATE * 10)
+
+static SnapshotCopyFunc s_copy_state;
+static uint32_t (*s_tell)(void);
+
+static Index<char> s_states[MAX_SNAPSHOTS];
+static uint32_t s_times[MAX_SNAPSHOTS];   /* in samples, ascending */
+static int s_count, s_slots;   /* s_slots is 0 if snapshots are disabled */
+static size_t s_state_size;
+static uint32_t s_interval, s_next;
+
+static void count_state(uint8_t **io, void *, size_t size)
+{
+    *io = (uint8_t *)((uintptr_t)*io + size);   /* *io starts out as 0 */
+}
+
+static void save_state(uint8_t **io, void *state, size_t size)
+{
+    memcpy(*io, state, size);
+    *io += size;
+}
+
+static void load_state(uint8_t **io, void *state, size_t size)
+{
+    memcpy(state, *io, size);
+    *io += size;
+}
+
+/* same rounding as psf_seek() and psf2_seek() */
+static uint32_t ms_to_samples(int ms)
+{
+    return (uint32_t)ms * 441 / 10;
+}
+
+/* latest snapshot at or before <time>, or -1 */
+static int find_snapshot(uint32_t time)
+{
+    int i = s_count;
+    while (i && s_times[i - 1] > time)
+        i--;
+
+    return i - 1;
+}
+
+void snapshot_free(void)
+{
+    for (Index<char> & state : s_states)
+        state.clear();
+
+    s_copy_state = nullptr;
+    s_tell = nullptr;
+    s_count = s_slots = 0;
+    s_state_size = 0;
+}
+
+/* called after the engine has started; the first snapshot is taken at the
+ * first frame, so that any seek can be served from the pool */
+void snapshot_init(SnapshotCopyFunc copy_state, uint32_t (*tell)(void))
+{
+    snapshot_free();
+
+    if (!copy_state || !tell)
+        return;
+
+    uint8_t *end = nullptr;
+    copy_state(&end, count_state);
+
+    s_state_size = (uintptr_t)end;
+    s_slots = aud::min((size_t)MAX_SNAPSHOTS, MEMORY_LIMIT / s_state_size);
+
+    if (s_slots < 2)
+    {
+        s_slots = 0;
+        return;
+    }
+
+    s_copy_state = copy_state;
+    s_tell = tell;
+    s_interval = INITIAL_INTERVAL;
+    s_next = 0;
+}
+
+void snapshot_frame(void)
+{
+    if (!s_slots)
+        return;
+
+    uint32_t now = s_tell();
+    if (now < s_next)
+        return;
+
+    if (s_count == s_slots)
+    {
+        /* out of room, so keep every other snapshot and take them half as often */
+        int n = 0;
+        for (int i = 0; i < s_count; i += 2, n++)
+        {
+            if (n != i)
+            {
+                std::swap(s_states[n], s_states[i]);
+                s_times[n] = s_times[i];
+            }
+        }
+
+        s_count = n;
+        s_interval *= 2;
+    }
+
+    Index<char> & state = s_states[s_count];
+    state.resize(s_state_size);
+
+    uint8_t *out = (uint8_t *)state.begin();
+    s_copy_state(&out, save_state);
+
+    s_times[s_count++] = now;
+    s_next = now + s_interval;
+}
+
+/* true if restoring a snapshot is faster than emulating from where we are */
+bool snapshot_can_seek(int ms)
+{
+    if (!s_slots)
+        return false;
+
+    uint32_t time = ms_to_samples(ms);
+    uint32_t now = s_tell();
+    int i = find_snapshot(time);
+
+    return i >= 0 && (time < now || s_times[i] > now);
+}
+
+/* call only between frames, i.e. after the engine's execute() returns */
+bool snapshot_restore(int ms)
+{
+    if (!s_slots)
+        return false;
+
+    int i = find_snapshot(ms_to_samples(ms));
+    if (i < 0)
+        return false;
+
+    uint8_t *in = (uint8_t *)s_states[i].begin();
+    s_copy_state(&in, load_state);
+
+    /* emulation is deterministic, so the later snapshots are still good */
+    s_next = s_times[s_count - 1] + s_interval;
+    return true;
+}
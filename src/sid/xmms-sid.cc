@@ -33,6 +33,7 @@
 
 #include "xs_config.h"
 #include "xs_sidplay2.h"
+#include "../plugin-common/output-rate.h"
 
 class SIDPlugin : public InputPlugin
 {
@@ -124,6 +125,22 @@ bool SIDPlugin::is_our_file(const char *filename, VFSFile &file)
 }
 
 
+/*
+ * Pick the rate to render at: if a resampling effect is enabled, use the
+ * rate it converts to, so that the output is only resampled once (by the
+ * emulator itself).
+ */
+static int xs_output_rate()
+{
+    int rate = effect_output_rate(xs_cfg.audioFrequency);
+
+    if (rate < 8000 || rate > 192000)
+        rate = xs_cfg.audioFrequency;
+
+    return rate;
+}
+
+
 /*
  * Start playing the given file
  */
@@ -142,6 +159,10 @@ bool SIDPlugin::play(const char *filename, VFSFile &file)
     if (!xs_sidplayfp_getinfo(info, buf.begin(), buf.len()))
         return false;
 
+    int rate = xs_output_rate();
+    if (!xs_sidplayfp_set_rate(rate))
+        return false;
+
     /* Initialize the tune */
     if (!xs_sidplayfp_load(buf.begin(), buf.len()))
         return false;
@@ -168,10 +189,10 @@ bool SIDPlugin::play(const char *filename, VFSFile &file)
     }
 
     /* Open the audio output */
-    open_audio(FMT_S16_NE, xs_cfg.audioFrequency, xs_cfg.audioChannels);
+    open_audio(FMT_S16_NE, rate, xs_cfg.audioChannels);
 
     /* Allocate audio buffer */
-    int audioBufSize = xs_cfg.audioFrequency * xs_cfg.audioChannels * 2;
+    int audioBufSize = rate * xs_cfg.audioChannels * 2;
     if (audioBufSize < 512)
         audioBufSize = 512;
 
@@ -180,8 +201,24 @@ bool SIDPlugin::play(const char *filename, VFSFile &file)
 
     while (! check_stop ())
     {
-        if (check_seek () >= 0)
-            AUDWARN ("Seeking is not implemented, ignoring.\n");
+        int seek = check_seek ();
+
+        if (seek >= 0) {
+            /* the engine can only run forward, so restart the sub-tune to
+             * go back */
+            int64_t target = aud::rescale<int64_t> (seek, 1000, rate) *
+             xs_cfg.audioChannels * 2;
+
+            if (target < bytes_played) {
+                if (!xs_sidplayfp_initsong(subTune))
+                    break;
+
+                bytes_played = 0;
+            }
+
+            bytes_played += xs_sidplayfp_skip(audioBuffer, audioBufSize,
+             target - bytes_played);
+        }
 
         int bufRemaining = xs_sidplayfp_fillbuffer(audioBuffer, audioBufSize);
 
@@ -190,7 +227,7 @@ bool SIDPlugin::play(const char *filename, VFSFile &file)
 
         /* Check if we have played enough */
         int time_played = aud::rescale<int64_t> (bytes_played,
-         xs_cfg.audioFrequency * xs_cfg.audioChannels * 2, 1000);
+         rate * xs_cfg.audioChannels * 2, 1000);
 
         if (xs_cfg.playMaxTimeEnable) {
             if (xs_cfg.playMaxTimeUnknown) {
@@ -0,0 +1,371 @@
+/*
+   XMMS-SID - SIDPlay input plugin for X MultiMedia System (XMMS)
+
+   Song length database
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * Songlengths.txt is several megabytes of text, one line per tune:
+ *
+ *   <MD5 of the tune>=m:ss m:ss(G) m:ss.mmm ...
+ *
+ * Instead of parsing it at every start, it is compiled once into a binary
+ * index (entries sorted by MD5, followed by the lengths in seconds) which is
+ * kept in the user directory and simply mapped into memory afterwards.
+ */
+
+#include "xs_length.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+
+#include <glib/gstdio.h>
+
+#include <libaudcore/audstrings.h>
+#include <libaudcore/index.h>
+#include <libaudcore/runtime.h>
+#include <libaudcore/vfs.h>
+
+#define INDEX_FILE "sid-songlengths.idx"
+#define INDEX_MAGIC "XSSL"
+#define INDEX_VERSION 1
+
+struct IndexHeader {
+    char magic[4];
+    uint32_t version;
+    int64_t dbSize, dbMtime;
+    uint32_t nEntries, nLengths;
+};
+
+struct IndexEntry {
+    uint8_t md5[16];
+    uint32_t first, count;
+};
+
+static const char *s_data;      /* header, entries, lengths */
+static int64_t s_dataSize;
+static bool s_mapped;
+static Index<char> s_built;     /* if the index was not mapped */
+
+static int xs_hexval(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+
+    return -1;
+}
+
+static bool xs_parse_md5(const char *str, uint8_t md5[16])
+{
+    for (int i = 0; i < 16; i++) {
+        int hi = xs_hexval(str[2 * i]);
+        int lo = (hi < 0) ? -1 : xs_hexval(str[2 * i + 1]);
+
+        if (lo < 0)
+            return false;
+
+        md5[i] = hi << 4 | lo;
+    }
+
+    return true;
+}
+
+/* Parse "m:ss", "m:ss.mmm", either optionally followed by "(X)"
+ */
+static bool xs_parse_time(const char *&str, int32_t &seconds)
+{
+    char *end;
+    long min = strtol(str, &end, 10);
+    if (end == str || *end != ':')
+        return false;
+
+    str = end + 1;
+    long sec = strtol(str, &end, 10);
+    if (end == str || min < 0 || sec < 0)
+        return false;
+
+    str = end;
+    seconds = min * 60 + sec;
+
+    if (*str == '.') {
+        if (str[1] >= '5' && str[1] <= '9')
+            seconds++;
+
+        do
+            str++;
+        while (*str >= '0' && *str <= '9');
+    }
+
+    if (*str == '(') {
+        const char *close = strchr(str, ')');
+        str = close ? close + 1 : str + strlen(str);
+    }
+
+    return true;
+}
+
+static bool xs_index_valid(const char *data, int64_t len, int64_t dbSize, int64_t dbMtime)
+{
+    IndexHeader header;
+
+    if (len < (int64_t) sizeof header)
+        return false;
+
+    memcpy(&header, data, sizeof header);
+
+    return !memcmp(header.magic, INDEX_MAGIC, 4) &&
+        header.version == INDEX_VERSION &&
+        header.dbSize == dbSize && header.dbMtime == dbMtime &&
+        len == (int64_t) sizeof header + header.nEntries * (int64_t) sizeof(IndexEntry) +
+            header.nLengths * (int64_t) sizeof(int32_t);
+}
+
+static bool xs_build_index(const char *dbFilename, int64_t dbSize, int64_t dbMtime,
+    Index<char> &out)
+{
+    VFSFile file(filename_to_uri(dbFilename), "r");
+    if (!file)
+        return false;
+
+    Index<char> text = file.read_all();
+    text.append(0);
+
+    Index<IndexEntry> entries;
+    Index<int32_t> lengths;
+
+    for (char *line = text.begin(); line && *line; ) {
+        char *next = strchr(line, '\n');
+        if (next)
+            *next++ = 0;
+
+        IndexEntry entry;
+
+        /* comments and section headers never start with 32 hex digits */
+        if (strlen(line) > 32 && line[32] == '=' && xs_parse_md5(line, entry.md5)) {
+            const char *str = line + 33;
+            int32_t seconds;
+
+            entry.first = lengths.len();
+            while (xs_parse_time(str, seconds))
+                lengths.append(seconds);
+
+            entry.count = lengths.len() - entry.first;
+            if (entry.count)
+                entries.append(entry);
+        }
+
+        line = next;
+    }
+
+    if (!entries.len())
+        return false;
+
+    std::sort(entries.begin(), entries.end(),
+        [](const IndexEntry &a, const IndexEntry &b)
+            { return memcmp(a.md5, b.md5, sizeof a.md5) < 0; });
+
+    IndexHeader header = IndexHeader();
+    memcpy(header.magic, INDEX_MAGIC, 4);
+    header.version = INDEX_VERSION;
+    header.dbSize = dbSize;
+    header.dbMtime = dbMtime;
+    header.nEntries = entries.len();
+    header.nLengths = lengths.len();
+
+    out.clear();
+    out.insert((const char *) &header, -1, sizeof header);
+    out.insert((const char *) entries.begin(), -1, entries.len() * sizeof(IndexEntry));
+    out.insert((const char *) lengths.begin(), -1, lengths.len() * sizeof(int32_t));
+
+    AUDDBG("Compiled %d song lengths for %d tunes.\n", lengths.len(), entries.len());
+    return true;
+}
+
+#ifndef _WIN32
+static bool xs_map_index(const char *path, int64_t dbSize, int64_t dbMtime)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    void *data = MAP_FAILED;
+
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+        data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+    close(fd);
+
+    if (data == MAP_FAILED)
+        return false;
+
+    if (!xs_index_valid((const char *) data, st.st_size, dbSize, dbMtime)) {
+        AUDDBG("Song length index is stale, rebuilding.\n");
+        munmap(data, st.st_size);
+        return false;
+    }
+
+    s_data = (const char *) data;
+    s_dataSize = st.st_size;
+    s_mapped = true;
+    return true;
+}
+#else
+/* A mapped file could not be replaced by another instance here, so the
+ * index is read into memory instead.
+ */
+static bool xs_map_index(const char *path, int64_t dbSize, int64_t dbMtime)
+{
+    VFSFile file(filename_to_uri(path), "r");
+    if (!file)
+        return false;
+
+    s_built = file.read_all();
+
+    if (!xs_index_valid(s_built.begin(), s_built.len(), dbSize, dbMtime)) {
+        AUDDBG("Song length index is stale, rebuilding.\n");
+        s_built.clear();
+        return false;
+    }
+
+    s_data = s_built.begin();
+    s_dataSize = s_built.len();
+    return true;
+}
+#endif
+
+/* Written under a temporary name first, since another instance may have
+ * the old index mapped.
+ */
+static void xs_save_index(const char *path, const Index<char> &data)
+{
+    StringBuf tmpPath = str_concat({path, ".tmp"});
+    bool written = false;
+
+    {
+        VFSFile file(filename_to_uri(tmpPath), "w");
+        if (file)
+            written = (file.fwrite(data.begin(), 1, data.len()) == data.len());
+    }
+
+    /* rename() does not replace an existing file on Windows */
+    if (written && g_rename(tmpPath, path) != 0) {
+        g_unlink(path);
+        written = (g_rename(tmpPath, path) == 0);
+    }
+
+    if (!written) {
+        AUDERR("Could not write song length index to %s.\n", path);
+        g_unlink(tmpPath);
+    }
+}
+
+
+/* Open the song length database, compiling the index if necessary
+ */
+bool xs_length_open(const char *dbFilename)
+{
+    xs_length_close();
+
+    struct stat st;
+    if (stat(dbFilename, &st) < 0)
+        return false;
+
+    StringBuf path = filename_build({aud_get_path(AudPath::UserDir), INDEX_FILE});
+
+    if (xs_map_index(path, st.st_size, st.st_mtime))
+        return true;
+
+    if (!xs_build_index(dbFilename, st.st_size, st.st_mtime, s_built))
+        return false;
+
+    xs_save_index(path, s_built);
+
+    s_data = s_built.begin();
+    s_dataSize = s_built.len();
+    return true;
+}
+
+
+void xs_length_close()
+{
+#ifndef _WIN32
+    if (s_mapped)
+        munmap((void *) s_data, s_dataSize);
+#endif
+
+    s_built.clear();
+    s_data = nullptr;
+    s_dataSize = 0;
+    s_mapped = false;
+}
+
+
+/* Look up the length (in seconds) of a sub-tune by the MD5 of the tune,
+ * given as 32 hex digits; returns -1 if it is not in the database
+ */
+int xs_length_get(const char *md5, int subTune)
+{
+    uint8_t key[16];
+
+    if (!s_data || !xs_parse_md5(md5, key))
+        return -1;
+
+    IndexHeader header;
+    memcpy(&header, s_data, sizeof header);
+
+    auto entries = (const IndexEntry *) (s_data + sizeof header);
+    auto lengths = (const int32_t *) (entries + header.nEntries);
+
+    int low = 0, high = header.nEntries;
+
+    while (low < high) {
+        int mid = (low + high) / 2;
+        int cmp = memcmp(entries[mid].md5, key, sizeof key);
+
+        if (cmp < 0)
+            low = mid + 1;
+        else if (cmp > 0)
+            high = mid;
+        else {
+            const IndexEntry &entry = entries[mid];
+
+            /* the index may have been damaged since it was written */
+            if (subTune < 1 || subTune > (int) entry.count ||
+                (uint64_t) entry.first + subTune - 1 >= header.nLengths)
+                return -1;
+
+            return lengths[entry.first + subTune - 1];
+        }
+    }
+
+    return -1;
+}
@@ -0,0 +1,8 @@
+#ifndef XS_LENGTH_H
+#define XS_LENGTH_H
+
+bool xs_length_open(const char *dbFilename);
+void xs_length_close();
+int xs_length_get(const char *md5, int subTune);
+
+#endif /* XS_LENGTH_H */
@@ -25,13 +25,12 @@
 */
 
 #include "xs_config.h"
+#include "xs_length.h"
 #include "xs_sidplay2.h"
 
-#include <pthread.h>
 #include <string.h>
 
 #include <sidplayfp/sidplayfp.h>
-#include <sidplayfp/SidDatabase.h>
 #include <sidplayfp/SidInfo.h>
 #include <sidplayfp/SidTune.h>
 #include <sidplayfp/SidTuneInfo.h>
@@ -45,9 +44,7 @@ struct SidState {
     sidbuilder *currBuilder;
     SidTune *currTune;
 
-    SidDatabase database;
     bool database_loaded = false;
-    pthread_mutex_t database_mutex = PTHREAD_MUTEX_INITIALIZER;
 };
 
 static SidState state;
@@ -155,7 +152,7 @@ bool xs_sidplayfp_init()
     }
 
     /* Load song length database */
-    state.database_loaded = state.database.open(SIDDATADIR "sidplayfp/Songlengths.txt");
+    state.database_loaded = xs_length_open(SIDDATADIR "sidplayfp/Songlengths.txt");
 
     /* Create the sidtune */
     state.currTune = new SidTune(0);
@@ -184,8 +181,10 @@ void xs_sidplayfp_close()
         state.currTune = nullptr;
     }
 
-    if (state.database_loaded)
-        state.database.close();
+    if (state.database_loaded) {
+        xs_length_close();
+        state.database_loaded = false;
+    }
 }
 
 
@@ -207,6 +206,27 @@ bool xs_sidplayfp_initsong(int subtune)
 }
 
 
+/* Change the output sample rate, if it differs from the current one
+ */
+bool xs_sidplayfp_set_rate(int rate)
+{
+    SidConfig config = state.currEng->config();
+
+    if (config.frequency == (uint_least32_t) rate)
+        return true;
+
+    config.frequency = rate;
+
+    if (!state.currEng->config(config)) {
+        AUDERR("[SIDPlayFP] Cannot set sample rate to %d Hz: %s\n",
+            rate, state.currEng->error());
+        return false;
+    }
+
+    return true;
+}
+
+
 /* Emulate and render audio data to given buffer
  */
 unsigned xs_sidplayfp_fillbuffer(char * audioBuffer, unsigned audioBufSize)
@@ -215,6 +235,53 @@ unsigned xs_sidplayfp_fillbuffer(char * audioBuffer, unsigned audioBufSize)
 }
 
 
+/* Emulate the given amount of audio data without rendering it, as fast as
+ * the engine allows; audioBuffer is only used as scratch space.  Returns the
+ * amount actually skipped, which is less if the engine stopped.
+ */
+int64_t xs_sidplayfp_skip(char *audioBuffer, unsigned audioBufSize, int64_t bytes)
+{
+    /* the engine mixes this many samples into each output sample */
+    const unsigned factor = 32;
+
+    unsigned frameSize = (state.currEng->config().playback == SidConfig::STEREO) ? 4 : 2;
+    unsigned chunk = audioBufSize / frameSize;
+    int64_t frames = bytes / frameSize;
+    int64_t done = 0;
+
+    if (!chunk)
+        return 0;
+
+    /* most of the way at full speed, the rest (less than one mixed sample)
+     * at the normal speed */
+    if (state.currEng->fastForward(factor * 100)) {
+        while (frames - done >= factor) {
+            unsigned count = aud::min<int64_t>(chunk, (frames - done) / factor);
+            unsigned played = state.currEng->play((short *)audioBuffer,
+                count * frameSize / 2) * 2 / frameSize;
+
+            done += (int64_t)played * factor;
+            if (played < count)
+                break;
+        }
+
+        state.currEng->fastForward(100);
+    }
+
+    while (done < frames) {
+        unsigned count = aud::min<int64_t>(chunk, frames - done);
+        unsigned played = state.currEng->play((short *)audioBuffer,
+            count * frameSize / 2) * 2 / frameSize;
+
+        done += played;
+        if (played < count)
+            break;
+    }
+
+    return done * frameSize;
+}
+
+
 /* Load a given SID-tune file
  */
 bool xs_sidplayfp_load(const void *buf, int64_t bufSize)
@@ -252,15 +319,12 @@ bool xs_sidplayfp_getinfo(xs_tuneinfo_t &ti, const void *buf, int64_t bufSize)
 
     if (state.database_loaded)
     {
-        pthread_mutex_lock(&state.database_mutex);
+        /* the MD5 covers all sub-tunes, so it is the same for each */
+        char md5[SidTune::MD5_LENGTH + 1];
+        myTune.createMD5(md5);
 
         for (int i = 0; i < ti.nsubTunes; i++)
-        {
-            myTune.selectSong(i + 1);
-            ti.subTunes[i].tuneLength = state.database.length(myTune);
-        }
-
-        pthread_mutex_unlock(&state.database_mutex);
+            ti.subTunes[i].tuneLength = xs_length_get(md5, i + 1);
     }
 
     return true;
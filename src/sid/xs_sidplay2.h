@@ -9,7 +9,9 @@ bool xs_sidplayfp_probe(const void *buf, int64_t bufSize);
 void xs_sidplayfp_close();
 bool xs_sidplayfp_init();
 bool xs_sidplayfp_initsong(int subtune);
+bool xs_sidplayfp_set_rate(int rate);
 unsigned xs_sidplayfp_fillbuffer(char *, unsigned);
+int64_t xs_sidplayfp_skip(char *, unsigned, int64_t);
 bool xs_sidplayfp_load(const void *buf, int64_t bufSize);
 bool xs_sidplayfp_getinfo(xs_tuneinfo_t &ti, const void *buf, int64_t bufSize);
 
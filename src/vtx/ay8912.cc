@@ -399,7 +399,6 @@ static void prepare_generation(ayemu_ay_t *ay)
 void *ayemu_gen_sound(ayemu_ay_t *ay, void *buff, size_t sound_bufsize)
 {
   int mix_l, mix_r;
-  int tmpvol;
   int m;
   int snd_numcount;
   unsigned char *sound_buf = (unsigned char *) buff;
@@ -409,56 +408,71 @@ void *ayemu_gen_sound(ayemu_ay_t *ay, void *buff, size_t sound_bufsize)
 
   prepare_generation(ay);
 
+  /* work on local copies, which the compiler can keep in registers */
+  int cnt_a = ay->cnt_a, cnt_b = ay->cnt_b, cnt_c = ay->cnt_c;
+  int cnt_n = ay->cnt_n, cnt_e = ay->cnt_e;
+  int bit_a = ay->bit_a, bit_b = ay->bit_b, bit_c = ay->bit_c, bit_n = ay->bit_n;
+  int env_pos = ay->env_pos, seed = ay->Cur_Seed;
+  const int tone_a = ay->regs.tone_a, tone_b = ay->regs.tone_b, tone_c = ay->regs.tone_c;
+  const int noise = ay->regs.noise * 2, env_freq = ay->regs.env_freq;
+  const int ta = !ay->regs.R7_tone_a, tb = !ay->regs.R7_tone_b, tc = !ay->regs.R7_tone_c;
+  const int na = !ay->regs.R7_noise_a, nb = !ay->regs.R7_noise_b, nc = !ay->regs.R7_noise_c;
+  int vol_a, vol_b, vol_c;
+
+#define ENVVOL Envelope [ay->regs.env_style][env_pos]
+#define SET_VOLS() do { \
+    vol_a = (ay->regs.env_a)? ENVVOL : ay->regs.vol_a * 2 + 1; \
+    vol_b = (ay->regs.env_b)? ENVVOL : ay->regs.vol_b * 2 + 1; \
+    vol_c = (ay->regs.env_c)? ENVVOL : ay->regs.vol_c * 2 + 1; \
+  } while (0)
+
+  SET_VOLS();
+
   snd_numcount = sound_bufsize / (ay->sndfmt.channels * (ay->sndfmt.bpc >> 3));
   while (snd_numcount-- > 0) {
     mix_l = mix_r = 0;
 
     for (m = 0 ; m < ay->ChipTacts_per_outcount ; m++) {
-      if (++ay->cnt_a >= ay->regs.tone_a) {
-	ay->cnt_a = 0;
-	ay->bit_a = ! ay->bit_a;
+      if (++cnt_a >= tone_a) {
+	cnt_a = 0;
+	bit_a = ! bit_a;
       }
-      if (++ay->cnt_b >= ay->regs.tone_b) {
-	ay->cnt_b = 0;
-	ay->bit_b = ! ay->bit_b;
+      if (++cnt_b >= tone_b) {
+	cnt_b = 0;
+	bit_b = ! bit_b;
       }
-      if (++ay->cnt_c >= ay->regs.tone_c) {
-	ay->cnt_c = 0;
-	ay->bit_c = ! ay->bit_c;
+      if (++cnt_c >= tone_c) {
+	cnt_c = 0;
+	bit_c = ! bit_c;
       }
 
       /* GenNoise (c) Hacker KAY & Sergey Bulba */
-      if (++ay->cnt_n >= (ay->regs.noise * 2)) {
-	ay->cnt_n = 0;
-	ay->Cur_Seed = (ay->Cur_Seed * 2 + 1) ^ \
-	  (((ay->Cur_Seed >> 16) ^ (ay->Cur_Seed >> 13)) & 1);
-	ay->bit_n = ((ay->Cur_Seed >> 16) & 1);
+      if (++cnt_n >= noise) {
+	cnt_n = 0;
+	seed = (seed * 2 + 1) ^ (((seed >> 16) ^ (seed >> 13)) & 1);
+	bit_n = ((seed >> 16) & 1);
       }
 
-      if (++ay->cnt_e >= ay->regs.env_freq) {
-	ay->cnt_e = 0;
-	if (++ay->env_pos > 127)
-	  ay->env_pos = 64;
+      if (++cnt_e >= env_freq) {
+	cnt_e = 0;
+	if (++env_pos > 127)
+	  env_pos = 64;
+	SET_VOLS();
       }
 
-#define ENVVOL Envelope [ay->regs.env_style][ay->env_pos]
-
-      if ((ay->bit_a | !ay->regs.R7_tone_a) & (ay->bit_n | !ay->regs.R7_noise_a)) {
-	tmpvol = (ay->regs.env_a)? ENVVOL : ay->regs.vol_a * 2 + 1;
-	mix_l += ay->vols[0][tmpvol];
-	mix_r += ay->vols[1][tmpvol];
+      if ((bit_a | ta) & (bit_n | na)) {
+	mix_l += ay->vols[0][vol_a];
+	mix_r += ay->vols[1][vol_a];
       }
 
-      if ((ay->bit_b | !ay->regs.R7_tone_b) & (ay->bit_n | !ay->regs.R7_noise_b)) {
-	tmpvol =(ay->regs.env_b)? ENVVOL :  ay->regs.vol_b * 2 + 1;
-	mix_l += ay->vols[2][tmpvol];
-	mix_r += ay->vols[3][tmpvol];
+      if ((bit_b | tb) & (bit_n | nb)) {
+	mix_l += ay->vols[2][vol_b];
+	mix_r += ay->vols[3][vol_b];
       }
 
-      if ((ay->bit_c | !ay->regs.R7_tone_c) & (ay->bit_n | !ay->regs.R7_noise_c)) {
-	tmpvol = (ay->regs.env_c)? ENVVOL : ay->regs.vol_c * 2 + 1;
-	mix_l += ay->vols[4][tmpvol];
-	mix_r += ay->vols[5][tmpvol];
+      if ((bit_c | tc) & (bit_n | nc)) {
+	mix_l += ay->vols[4][vol_c];
+	mix_r += ay->vols[5][vol_c];
       }
     } /* end for (m=0; ...) */
 
@@ -480,6 +494,12 @@ void *ayemu_gen_sound(ayemu_ay_t *ay, void *buff, size_t sound_bufsize)
       }
     }
   }
+
+  ay->cnt_a = cnt_a; ay->cnt_b = cnt_b; ay->cnt_c = cnt_c;
+  ay->cnt_n = cnt_n; ay->cnt_e = cnt_e;
+  ay->bit_a = bit_a; ay->bit_b = bit_b; ay->bit_c = bit_c; ay->bit_n = bit_n;
+  ay->env_pos = env_pos; ay->Cur_Seed = seed;
+
   return sound_buf;
 }
 
@@ -1,6 +1,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include <wavpack/wavpack.h>
 
 #define WANT_VFS_STDIO_COMPAT
@@ -9,8 +13,11 @@
 #include <libaudcore/i18n.h>
 #include <libaudcore/plugin.h>
 #include <libaudcore/audstrings.h>
+#include <libaudcore/preferences.h>
 
-#define BUFFER_SIZE 256 /* read buffer size, in samples / frames */
+/* read buffer size, in samples / frames */
+#define MIN_BUFFER_SIZE 256
+#define MAX_BUFFER_SIZE 65536
 #define SAMPLE_SIZE(a) (a <= 8 ? sizeof(uint8_t) : (a <= 16 ? sizeof(uint16_t) : sizeof(uint32_t)))
 #define SAMPLE_FMT(a) (a <= 8 ? FMT_S8 : (a <= 16 ? FMT_S16_NE : (a <= 24 ? FMT_S24_NE : FMT_S32_NE)))
 
@@ -20,17 +27,23 @@ public:
     static const char about[];
     static const char * const exts[];
     static const char * const mimes[];
+    static const char * const defaults[];
+    static const PreferencesWidget widgets[];
+    static const PluginPreferences prefs;
 
     static constexpr PluginInfo info = {
         N_("WavPack Decoder"),
         PACKAGE,
-        about
+        about,
+        & prefs
     };
 
     constexpr WavpackPlugin() : InputPlugin (info, InputInfo (FlagWritesTag)
         .with_exts (exts)
         .with_mimes (mimes)) {}
 
+    bool init ();
+
     bool is_our_file (const char * filename, VFSFile & file)
         { return false; }
 
@@ -41,6 +54,26 @@ public:
 
 EXPORT WavpackPlugin aud_plugin_instance;
 
+const char * const WavpackPlugin::defaults[] = {
+    "buffer_size", "4096",
+    nullptr
+};
+
+const PreferencesWidget WavpackPlugin::widgets[] = {
+    WidgetLabel (N_("<b>Advanced</b>")),
+    WidgetSpin (N_("Decode buffer size:"),
+        WidgetInt ("wavpack", "buffer_size"),
+        {MIN_BUFFER_SIZE, MAX_BUFFER_SIZE, 256, N_("frames")})
+};
+
+const PluginPreferences WavpackPlugin::prefs = {{widgets}};
+
+bool WavpackPlugin::init ()
+{
+    aud_config_set_defaults ("wavpack", defaults);
+    return true;
+}
+
 /* Audacious VFS wrappers for Wavpack stream reading
  */
 
@@ -122,6 +155,45 @@ static void wv_deattach (WavpackContext * ctx)
     WavpackCloseFile(ctx);
 }
 
+/* Narrow unpacked samples, which are already within range, to 16 or 8 bits.
+ * 24- and 32-bit (including float) samples need no conversion at all. */
+
+static void pack_s16 (const int32_t * in, int16_t * out, int count)
+{
+    int i = 0;
+
+#ifdef __SSE2__
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i a = _mm_loadu_si128 ((const __m128i *) (in + i));
+        __m128i b = _mm_loadu_si128 ((const __m128i *) (in + i + 4));
+        _mm_storeu_si128 ((__m128i *) (out + i), _mm_packs_epi32 (a, b));
+    }
+#endif
+
+    for (; i < count; i ++)
+        out[i] = in[i];
+}
+
+static void pack_s8 (const int32_t * in, int8_t * out, int count)
+{
+    int i = 0;
+
+#ifdef __SSE2__
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i a = _mm_packs_epi32 (_mm_loadu_si128 ((const __m128i *) (in + i)),
+         _mm_loadu_si128 ((const __m128i *) (in + i + 4)));
+        __m128i b = _mm_packs_epi32 (_mm_loadu_si128 ((const __m128i *) (in + i + 8)),
+         _mm_loadu_si128 ((const __m128i *) (in + i + 12)));
+        _mm_storeu_si128 ((__m128i *) (out + i), _mm_packs_epi16 (a, b));
+    }
+#endif
+
+    for (; i < count; i ++)
+        out[i] = in[i];
+}
+
 bool WavpackPlugin::play (const char * filename, VFSFile & file)
 {
     int sample_rate, num_channels, bits_per_sample;
@@ -147,11 +219,16 @@ bool WavpackPlugin::play (const char * filename, VFSFile & file)
     else
         open_audio(SAMPLE_FMT(bits_per_sample), sample_rate, num_channels);
 
+    int buffer_size = aud::clamp (aud_get_int ("wavpack", "buffer_size"),
+     MIN_BUFFER_SIZE, MAX_BUFFER_SIZE);
+
     Index<int32_t> input;
-    input.resize (BUFFER_SIZE * num_channels);
+    input.resize (buffer_size * num_channels);
 
+    /* 24- and 32-bit output is written straight from the input buffer */
     Index<char> output;
-    output.resize (BUFFER_SIZE * num_channels * SAMPLE_SIZE (bits_per_sample));
+    if (SAMPLE_SIZE (bits_per_sample) < sizeof (int32_t))
+        output.resize (buffer_size * num_channels * SAMPLE_SIZE (bits_per_sample));
 
     while (! check_stop ())
     {
@@ -165,7 +242,7 @@ bool WavpackPlugin::play (const char * filename, VFSFile & file)
         if (samples_left == 0)
             break;
 
-        int ret = WavpackUnpackSamples (ctx, input.begin (), BUFFER_SIZE);
+        int ret = WavpackUnpackSamples (ctx, input.begin (), buffer_size);
 
         if (ret < 0)
         {
@@ -175,29 +252,20 @@ bool WavpackPlugin::play (const char * filename, VFSFile & file)
         else
         {
             /* Perform audio data conversion and output */
-            int32_t * rp = input.begin ();
-            int8_t * wp = (int8_t *) output.begin ();
-            int16_t * wp2 = (int16_t *) output.begin ();
-            int32_t * wp4 = (int32_t *) output.begin ();
+            int count = ret * num_channels;
 
             if (bits_per_sample <= 8)
             {
-                for (int i = 0; i < ret * num_channels; i++, wp++, rp++)
-                    *wp = *rp & 0xff;
+                pack_s8 (input.begin (), (int8_t *) output.begin (), count);
+                write_audio (output.begin (), count * sizeof (int8_t));
             }
             else if (bits_per_sample <= 16)
             {
-                for (int i = 0; i < ret * num_channels; i++, wp2++, rp++)
-                    *wp2 = *rp & 0xffff;
+                pack_s16 (input.begin (), (int16_t *) output.begin (), count);
+                write_audio (output.begin (), count * sizeof (int16_t));
             }
             else
-            {
-                for (int i = 0; i < ret * num_channels; i++, wp4++, rp++)
-                    *wp4 = *rp;
-            }
-
-            write_audio (output.begin (),
-             ret * num_channels * SAMPLE_SIZE (bits_per_sample));
+                write_audio (input.begin (), count * sizeof (int32_t));
         }
     }
 
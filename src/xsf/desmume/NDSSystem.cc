@@ -536,6 +536,102 @@ static void timer_check(void)
 	}
 }
 
+#define LINE_CYCLES (99 * 12 + 256 * 12)
+
+static BOOL cpu_idle(armcpu_t *armcpu, int proc)
+{
+	if (!armcpu->waitIRQ && !armcpu_spinning(armcpu))
+		return false;
+
+	return !((MMU.reg_IF[proc] & MMU.reg_IE[proc]) && MMU.reg_IME[proc]);
+}
+
+static u32 vcount_match(u8 *regs)
+{
+	u32 vmatch = T1ReadWord(regs, 4);
+	return (vmatch >> 8) | ((vmatch << 1) & 256);
+}
+
+/* Returns how many of the next <max> scanlines can be skipped with
+   NDS_skip_lines().  That is possible while both CPUs wait for an interrupt
+   and none can be raised: a line then only moves VCOUNT and the timers on.
+   The run stops short of VBlank, the end of the frame, a VCOUNT match and the
+   next timer overflow, and there is none while HBlank interrupts or DMA are
+   in use, so every event is still handled by NDS_exec_hframe(). */
+int NDS_idle_lines(int max)
+{
+	int p, t, lines;
+
+	if (!cpu_idle(&NDS_ARM9, 0) || !cpu_idle(&NDS_ARM7, 1))
+		return 0;
+	if ((T1ReadWord(ARM9Mem.ARM9_REG, 4) | T1ReadWord(MMU.ARM7_REG, 4)) & 0x10)
+		return 0;
+
+	for (p = 0; p < 2; p++)
+	{
+		for (t = 0; t < 4; t++)
+		{
+			u32 start = MMU.DMAStartTime[p][t];
+			if (MMU.DMAing[p][t] || start == 4 || (p == 0 && (start == 2 || start == 3)))
+				return 0;
+		}
+	}
+
+	/* the lines that would be run are VCount + 1 ... VCount + lines */
+	lines = 0;
+	while (lines < max)
+	{
+		u32 v = nds.VCount + lines + 1;
+		if (v == 192 || v >= 263)
+			break;
+		if (v == vcount_match(ARM9Mem.ARM9_REG) || v == vcount_match(MMU.ARM7_REG))
+			break;
+		lines++;
+	}
+
+	for (p = 0; p < 2; p++)
+	{
+		for (t = 0; t < 4; t++)
+		{
+			s64 left;
+			u32 mode = MMU.timerMODE[p][t];
+
+			if (!MMU.timerON[p][t] || mode == 0xFFFF)
+				continue;
+			if (!MMU.timerRUN[p][t])
+				return 0;
+
+			/* cycles until the counter wraps */
+			left = ((((s64)nds.timerCycle[p][t] >> mode) + 0x10000 - MMU.timer[p][t]) << mode) - nds.cycles;
+			if (left <= 0)
+				return 0;
+			if ((left - 1) / LINE_CYCLES < lines)
+				lines = (left - 1) / LINE_CYCLES;
+		}
+	}
+
+	return lines;
+}
+
+/* Does what NDS_exec_hframe() would do for <lines> lines allowed by
+   NDS_idle_lines(). */
+void NDS_skip_lines(int lines)
+{
+	nds.cycles += lines * LINE_CYCLES;
+	nds.ARM9Cycle = nds.ARM7Cycle = nds.cycles;
+	nds.nextHBlank += lines * 4260;
+	nds.VCount += lines;
+
+	/* in HBlank, on a line that does not match */
+	T1WriteWord(ARM9Mem.ARM9_REG, 4, (T1ReadWord(ARM9Mem.ARM9_REG, 4) | 2) & 0xFFFB);
+	T1WriteWord(MMU.ARM7_REG, 4, (T1ReadWord(MMU.ARM7_REG, 4) | 2) & 0xFFFB);
+	T1WriteWord(ARM9Mem.ARM9_REG, 6, nds.VCount);
+	T1WriteWord(MMU.ARM7_REG, 6, nds.VCount);
+
+	timer_check();
+	dma_check();
+}
+
 void NDS_exec_hframe(int cpu_clockdown_level_arm9, int cpu_clockdown_level_arm7)
 {
 	int h;
@@ -543,12 +639,14 @@ void NDS_exec_hframe(int cpu_clockdown_level_arm9, int cpu_clockdown_level_arm7)
 	{
 		s32 nb = nds.cycles + (h ? (99 * 12) : (256 * 12));
 
-		while (nb > nds.ARM9Cycle && !NDS_ARM9.waitIRQ)
+		/* interrupts are only taken between these runs, so a CPU that is
+		   halted or spinning in place can skip straight to the end */
+		while (nb > nds.ARM9Cycle && !NDS_ARM9.waitIRQ && !armcpu_spinning(&NDS_ARM9))
 			nds.ARM9Cycle += armcpu_exec(&NDS_ARM9) << (cpu_clockdown_level_arm9);
-		if (NDS_ARM9.waitIRQ) nds.ARM9Cycle = nb;
-		while (nb > nds.ARM7Cycle && !NDS_ARM7.waitIRQ)
+		if (NDS_ARM9.waitIRQ || armcpu_spinning(&NDS_ARM9)) nds.ARM9Cycle = nb;
+		while (nb > nds.ARM7Cycle && !NDS_ARM7.waitIRQ && !armcpu_spinning(&NDS_ARM7))
 			nds.ARM7Cycle += armcpu_exec(&NDS_ARM7) << (1 + (cpu_clockdown_level_arm7));
-		if (NDS_ARM7.waitIRQ) nds.ARM7Cycle = nb;
+		if (NDS_ARM7.waitIRQ || armcpu_spinning(&NDS_ARM7)) nds.ARM7Cycle = nb;
 		nds.cycles = (nds.ARM9Cycle<nds.ARM7Cycle)?nds.ARM9Cycle : nds.ARM7Cycle;
 
 		/* HBLANK */
@@ -739,10 +837,20 @@ void NDS_exec_hframe(int cpu_clockdown_level_arm9, int cpu_clockdown_level_arm7)
 
 void NDS_exec_frame(int cpu_clockdown_level_arm9, int cpu_clockdown_level_arm7)
 {
-	int v;
-	for (v = 0; v < 263; v++)
+	int v = 0;
+	while (v < 263)
 	{
-		NDS_exec_hframe(cpu_clockdown_level_arm9, cpu_clockdown_level_arm7);
+		int lines = NDS_idle_lines(263 - v);
+		if (lines)
+		{
+			NDS_skip_lines(lines);
+			v += lines;
+		}
+		else
+		{
+			NDS_exec_hframe(cpu_clockdown_level_arm9, cpu_clockdown_level_arm7);
+			v++;
+		}
 	}
 }
 
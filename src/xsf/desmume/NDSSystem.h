@@ -242,6 +242,8 @@ NDS_exec(s32 nb, BOOL force);
 
 void NDS_exec_frame(int cpu_clockdown_level_arm9, int cpu_clockdown_level_arm7);
 void NDS_exec_hframe(int cpu_clockdown_level_arm9, int cpu_clockdown_level_arm7);
+int NDS_idle_lines(int max);
+void NDS_skip_lines(int lines);
 
 #endif
 
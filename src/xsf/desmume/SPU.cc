@@ -73,6 +73,7 @@ typedef struct
 } SPU_struct;
 
 static SPU_struct spu = { 0, 0, 0 };
+static int spu_sample_rate = 44100;
 
 static SoundInterface_struct *SNDCore=nullptr;
 extern SoundInterface_struct *SNDCoreList[];
@@ -212,9 +213,15 @@ void SPU_KeyOn(int channel)
 {
 }
 
+/* must be called before SPU_Reset() */
+void SPU_SetSampleRate(int rate)
+{
+	spu_sample_rate = rate;
+}
+
 static INLINE void adjust_channel_timer(SChannel *ch)
 {
-	ch->inc = (((double)33512000) / (44100 * 2)) / (double)(0x10000 - ch->timer);
+	ch->inc = (((double)33512000) / (spu_sample_rate * 2)) / (double)(0x10000 - ch->timer);
 }
 
 static int check_valid(u32 addr, u32 size)
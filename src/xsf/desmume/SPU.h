@@ -42,6 +42,7 @@ extern SoundInterface_struct SNDDummy;
 
 int SPU_ChangeSoundCore(int coreid, int buffersize);
 int SPU_Init(int coreid, int buffersize);
+void SPU_SetSampleRate(int rate);
 void SPU_Pause(int pause);
 void SPU_SetVolume(int volume);
 void SPU_Reset(void);
@@ -23,6 +23,7 @@
 #include "thumb_instructions.h"
 #include "cp15.h"
 #include "bios.h"
+#include "mem.h"
 #include <stdlib.h>
 #include <stdio.h>
 
@@ -317,8 +318,27 @@ u32 armcpu_switchMode(armcpu_t *armcpu, u8 mode)
 	return oldmode;
 }
 
+/* Code nearly always runs from main RAM or WRAM (0x02xxxxxx, 0x03xxxxxx),
+   which the full MMU read only looks up in the memory map, so fetch it from
+   there directly.  The ARM9 DTCM can overlay main RAM and still takes the
+   full path.  Decoding is left to armcpu_exec(): it is two table lookups,
+   and a cache of decoded handlers measured slower than doing them again. */
+static INLINE BOOL armcpu_direct_fetch(armcpu_t *armcpu, u32 adr)
+{
+#ifdef MMU_ENABLE_ACL
+	return 0;
+#else
+	if((adr & 0x0E000000) != 0x02000000)
+		return 0;
+
+	return armcpu->proc_ID != ARMCPU_ARM9 || (adr & ~0x3FFF) != MMU.DTCMRegion;
+#endif
+}
+
 u32 armcpu_prefetch(armcpu_t *armcpu)
 {
+	u32 adr = armcpu->next_instruction;
+
 #ifdef GDB_STUB
 	u32 temp_instruction;
 #endif
@@ -337,7 +357,10 @@ u32 armcpu_prefetch(armcpu_t *armcpu)
 			armcpu->R[15] = armcpu->next_instruction + 4;
 		}
 #else
-		armcpu->instruction = MMU_read32_acl(armcpu->proc_ID, armcpu->next_instruction,CP15_ACCESS_EXECUTE);
+		if(armcpu_direct_fetch(armcpu, adr))
+			armcpu->instruction = T1ReadLong(MMU.MMU_MEM[armcpu->proc_ID][(adr >> 20) & 0xFF], adr & MMU.MMU_MASK[armcpu->proc_ID][(adr >> 20) & 0xFF]);
+		else
+			armcpu->instruction = MMU_read32_acl(armcpu->proc_ID, adr,CP15_ACCESS_EXECUTE);
 
 		armcpu->instruct_adr = armcpu->next_instruction;
 		armcpu->next_instruction += 4;
@@ -359,7 +382,10 @@ u32 armcpu_prefetch(armcpu_t *armcpu)
 		armcpu->R[15] = armcpu->next_instruction + 2;
 	}
 #else
-	armcpu->instruction = MMU_read16_acl(armcpu->proc_ID, armcpu->next_instruction,CP15_ACCESS_EXECUTE);
+	if(armcpu_direct_fetch(armcpu, adr))
+		armcpu->instruction = T1ReadWord(MMU.MMU_MEM[armcpu->proc_ID][(adr >> 20) & 0xFF], adr & MMU.MMU_MASK[armcpu->proc_ID][(adr >> 20) & 0xFF]);
+	else
+		armcpu->instruction = MMU_read16_acl(armcpu->proc_ID, adr,CP15_ACCESS_EXECUTE);
 
 	armcpu->instruct_adr = armcpu->next_instruction;
 	armcpu->next_instruction += 2;
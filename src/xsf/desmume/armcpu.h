@@ -237,6 +237,16 @@ armcpu_flagIrq( armcpu_t *armcpu);
 extern armcpu_t NDS_ARM7;
 extern armcpu_t NDS_ARM9;
 
+/* true if the CPU sits on a branch to itself, which only an interrupt can
+   get it out of; like waitIRQ, the rest of the time slice can be skipped */
+static INLINE BOOL armcpu_spinning(const armcpu_t *armcpu)
+{
+	if(armcpu->CPSR.bits.T)
+		return (armcpu->instruction & 0xFFFF) == 0xE7FE;	/* b . */
+
+	return armcpu->instruction == 0xEAFFFFFE;	/* b . */
+}
+
 static INLINE void NDS_makeARM9Int(u32 num)
 {
         /* flag the interrupt request source */
@@ -0,0 +1 @@
+#include "../plugin-common/corlett-libcache.cc"
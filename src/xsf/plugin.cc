@@ -35,8 +35,9 @@
 #include <libaudcore/runtime.h>
 
 #include "ao.h"
-#include "corlett.h"
+#include "../plugin-common/corlett.h"
 #include "vio2sf.h"
+#include "../plugin-common/output-rate.h"
 
 class XSFPlugin : public InputPlugin
 {
@@ -82,20 +83,15 @@ bool XSFPlugin::init()
 	return true;
 }
 
-Index<char> xsf_get_lib(char *filename)
+Index<char> xsf_get_lib(char *filename, Index<char> *program)
 {
-	VFSFile file(filename_build({dirpath, filename}), "r");
-	return file ? file.read_all() : Index<char>();
+	return corlett_get_lib(filename_build({dirpath, filename}), program);
 }
 
 bool XSFPlugin::read_tag(const char *filename, VFSFile &file, Tuple &tuple, Index<char> *image)
 {
-	Index<char> buf = file.read_all ();
-	if (!buf.len())
-		return false;
-
 	corlett_t *c;
-	if (corlett_decode((uint8_t *)buf.begin(), buf.len(), nullptr, nullptr, &c) != AO_SUCCESS)
+	if (corlett_read_tags(file, &c) != AO_SUCCESS)
 		return false;
 
 	tuple.set_int(Tuple::Length, psfTimeToMS(c->inf_length) + psfTimeToMS(c->inf_fade));
@@ -126,11 +122,25 @@ static int xsf_get_length(const Index<char> &buf)
 	return length;
 }
 
+/* The SPU renders at any multiple of 100 Hz; if a resampling effect is
+ * enabled, render at its output rate rather than having it convert. */
+static int xsf_output_rate()
+{
+	int rate = effect_output_rate(44100);
+
+	if (rate < 8000 || rate > 192000 || rate % 100)
+		rate = 44100;
+
+	return rate;
+}
+
 bool XSFPlugin::play(const char *filename, VFSFile &file)
 {
 	int length = -1;
-	int16_t samples[44100*2];
-	int seglen = 44100 / 60;
+	int rate = xsf_output_rate();
+	int16_t samples[192000 / 60 * 2];
+	int seglen = rate / 60;
+	float seglen_ms = seglen * 1000.0f / rate;
 	float pos = 0.0;
 	bool error = false;
 
@@ -150,14 +160,14 @@ bool XSFPlugin::play(const char *filename, VFSFile &file)
 
 	length = xsf_get_length(buf);
 
-	if (xsf_start(buf.begin(), buf.len()) != AO_SUCCESS)
+	if (xsf_start(buf.begin(), buf.len(), rate) != AO_SUCCESS)
 	{
 		error = true;
 		goto ERR_NO_CLOSE;
 	}
 
-	set_stream_bitrate(44100*2*2*8);
-	open_audio(FMT_S16_NE, 44100, 2);
+	set_stream_bitrate(rate*2*2*8);
+	open_audio(FMT_S16_NE, rate, 2);
 
 	while (! check_stop ())
 	{
@@ -170,20 +180,20 @@ bool XSFPlugin::play(const char *filename, VFSFile &file)
 				while (pos < seek_value)
 				{
 					xsf_gen(samples, seglen);
-					pos += 16.666;
+					pos += seglen_ms;
 				}
 			}
 			else if (seek_value < pos)
 			{
 				xsf_term();
 
-				if (xsf_start(buf.begin(), buf.len()) == AO_SUCCESS)
+				if (xsf_start(buf.begin(), buf.len(), rate) == AO_SUCCESS)
 				{
 					pos = 0.0;
 					while (pos < seek_value)
 					{
 						xsf_gen(samples, seglen);
-						pos += 16.666; /* each segment is 16.666ms */
+						pos += seglen_ms;
 					}
 				}
 			   	else
@@ -195,7 +205,7 @@ bool XSFPlugin::play(const char *filename, VFSFile &file)
 		}
 
 		xsf_gen(samples, seglen);
-		pos += 16.666;
+		pos += seglen_ms;
 
 		write_audio(samples, seglen * 4);
 
@@ -169,7 +169,8 @@ static int load_mapz(int issave, unsigned char *zdata, unsigned zsize, unsigned
 	return ret;
 }
 
-static int load_psf_one(unsigned char *pfile, unsigned bytes)
+/* <program> is the code section already inflated, if the caller has it */
+static int load_psf_one(unsigned char *pfile, unsigned bytes, Index<char> *program)
 {
 	unsigned char *ptr = pfile;
 	unsigned code_size;
@@ -208,7 +209,12 @@ static int load_psf_one(unsigned char *pfile, unsigned bytes)
 		ptr = pfile + 16 + resv_size;
 		if (16 + resv_size + code_size > bytes)
 			return false;
-		if (!load_mapz(0, ptr, code_size, code_crc))
+		if (program && program->len() >= 8)
+		{
+			if (!load_map(0, (unsigned char *) program->begin(), program->len()))
+				return false;
+		}
+		else if (!load_mapz(0, ptr, code_size, code_crc))
 			return false;
 	}
 
@@ -232,11 +238,12 @@ static int load_psfcb(void *pWork, const char *pNameTop, const char *pNameEnd, c
 	if (pNameEnd - pNameTop == pwork->taglen && !strcmp_nocase(pNameTop, pwork->tag, pwork->taglen))
 	{
 		StringBuf lib = str_copy(pValueTop, pValueEnd - pValueTop);
-		Index<char> buf = xsf_get_lib(lib);
+		Index<char> program;
+		Index<char> buf = xsf_get_lib(lib, &program);
 
 		if (buf.len() &&
 			load_libs(pwork->level + 1, buf.begin(), buf.len()) &&
-			load_psf_one((unsigned char *) buf.begin(), buf.len()))
+			load_psf_one((unsigned char *) buf.begin(), buf.len(), &program))
 		{
 			pwork->found++;
 		}
@@ -284,7 +291,7 @@ static int load_psf(void *pfile, unsigned bytes)
 {
 	load_term();
 
-	if (!load_libs(1, pfile, bytes) || !load_psf_one((unsigned char *) pfile, bytes))
+	if (!load_libs(1, pfile, bytes) || !load_psf_one((unsigned char *) pfile, bytes, nullptr))
 		return false;
 
 	return true;
@@ -539,11 +546,17 @@ static struct
 	unsigned used;
 	u32 bufferbytes;
 	u32 cycles;
+	int rate;
 	int xfs_load;
 	int sync_type;
 	int arm7_clockdown_level;
 	int arm9_clockdown_level;
-} sndifwork = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+} sndifwork = { 0, 0, 0, 0, 0, 0, 44100, 0, 0, 0, 0};
+
+#define HBASE_CYCLES 33509300.322234
+#define VBASE_CYCLES (((double)HBASE_CYCLES) / 100)
+#define HSAMPLES ((u32)(((double)sndifwork.rate * 6 * (99 + 256)) / HBASE_CYCLES))
+#define VSAMPLES ((u32)(((double)sndifwork.rate * 6 * (99 + 256) * 263) / HBASE_CYCLES))
 
 static void SNDIFDeInit(void)
 {
@@ -615,7 +628,7 @@ static struct armcpu_ctrl_iface *arm9_ctrl_iface = 0;
 static struct armcpu_ctrl_iface *arm7_ctrl_iface = 0;
 #endif
 
-int xsf_start(void *pfile, unsigned bytes)
+int xsf_start(void *pfile, unsigned bytes, int rate)
 {
 	int frames = xsf_tagget_int("_frames", (unsigned char *) pfile, bytes, -1);
 	int clockdown = xsf_tagget_int("_clockdown", (unsigned char *) pfile, bytes, 0);
@@ -623,6 +636,10 @@ int xsf_start(void *pfile, unsigned bytes)
 	sndifwork.arm9_clockdown_level = xsf_tagget_int("_vio2sf_arm9_clockdown_level", (unsigned char *) pfile, bytes, clockdown);
 	sndifwork.arm7_clockdown_level = xsf_tagget_int("_vio2sf_arm7_clockdown_level", (unsigned char *) pfile, bytes, clockdown);
 
+	/* the vsync timing below needs a multiple of 100 Hz */
+	sndifwork.rate = (rate > 0 && rate % 100 == 0) ? rate : 44100;
+	SPU_SetSampleRate(sndifwork.rate);
+
 	sndifwork.xfs_load = 0;
 	printf("load_psf... ");
 	if (!load_psf(pfile, bytes))
@@ -636,7 +653,7 @@ int xsf_start(void *pfile, unsigned bytes)
 #endif
 		return false;
 
-	SPU_ChangeSoundCore(VIO2SFSNDIFID, 737);
+	SPU_ChangeSoundCore(VIO2SFSNDIFID, VSAMPLES);
 
 	execute = false;
 
@@ -776,16 +793,11 @@ int xsf_gen(void *pbuffer, unsigned samples)
 		if (remainbytes == 0)
 		{
 
-#define HBASE_CYCLES 33509300.322234
-#define VBASE_CYCLES (((double)HBASE_CYCLES) / 100)
-#define HSAMPLES ((u32)((44100.0 * 6 * (99 + 256)) / HBASE_CYCLES))
-#define VSAMPLES ((u32)((44100.0 * 6 * (99 + 256) * 263) / HBASE_CYCLES))
-
 			int numsamples;
 			if (sndifwork.sync_type == 1)
 			{
 				/* vsync */
-				sndifwork.cycles += (441 * 6 * (99 + 256) * 263);
+				sndifwork.cycles += ((sndifwork.rate / 100) * 6 * (99 + 256) * 263);
 				if (sndifwork.cycles >= (u32)(VBASE_CYCLES * (VSAMPLES + 1)))
 				{
 					numsamples = (VSAMPLES + 1);
@@ -800,19 +812,31 @@ int xsf_gen(void *pbuffer, unsigned samples)
 			}
 			else
 			{
-				/* hsync */
-				sndifwork.cycles += (44100 * 6 * (99 + 256));
-				if (sndifwork.cycles >= (u32)(HBASE_CYCLES * (HSAMPLES + 1)))
+				/* hsync; lines on which both CPUs sleep are run in one go,
+				   as far as their samples fit in the buffer */
+				int idle = NDS_idle_lines(263);
+				int lines = 0;
+				numsamples = 0;
+				do
 				{
-					numsamples = (HSAMPLES + 1);
-					sndifwork.cycles -= (u32)(HBASE_CYCLES * (HSAMPLES + 1));
+					sndifwork.cycles += (sndifwork.rate * 6 * (99 + 256));
+					if (sndifwork.cycles >= (u32)(HBASE_CYCLES * (HSAMPLES + 1)))
+					{
+						numsamples += (HSAMPLES + 1);
+						sndifwork.cycles -= (u32)(HBASE_CYCLES * (HSAMPLES + 1));
+					}
+					else
+					{
+						numsamples += (HSAMPLES + 0);
+						sndifwork.cycles -= (u32)(HBASE_CYCLES * (HSAMPLES + 0));
+					}
+					lines++;
 				}
+				while (lines < idle && numsamples + HSAMPLES + 1 <= VSAMPLES);
+				if (idle)
+					NDS_skip_lines(lines);
 				else
-				{
-					numsamples = (HSAMPLES + 0);
-					sndifwork.cycles -= (u32)(HBASE_CYCLES * (HSAMPLES + 0));
-				}
-				NDS_exec_hframe(sndifwork.arm9_clockdown_level, sndifwork.arm7_clockdown_level);
+					NDS_exec_hframe(sndifwork.arm9_clockdown_level, sndifwork.arm7_clockdown_level);
 			}
 			SPU_EmulateSamples(numsamples);
 		}
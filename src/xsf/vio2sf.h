@@ -1,6 +1,6 @@
 #include <libaudcore/index.h>
 
-int xsf_start(void *pfile, unsigned bytes);
+int xsf_start(void *pfile, unsigned bytes, int rate);
 int xsf_gen(void *pbuffer, unsigned samples);
-Index<char> xsf_get_lib(char *pfilename);
+Index<char> xsf_get_lib(char *pfilename, Index<char> *program = nullptr);
 void xsf_term(void);